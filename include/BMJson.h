@@ -25,14 +25,82 @@ SOFTWARE.
 #pragma once
 #include <cstdint>
 #include <optional>
+#include <ostream>
 #include <stdexcept>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
 #include <cctype>
+#include <cerrno>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <format>
 #include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if !defined(BMJSON_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    #define BMJSON_X64 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define BMJSON_TARGET_AVX2
+    #else
+        #define BMJSON_TARGET_AVX2 __attribute__((target("avx2"), flatten))
+    #endif
+#else
+    #define BMJSON_X64 0
+#endif
+
+#if defined(_WIN32)
+    #include <io.h>
+
+    // The few Win32 functions used for file mapping are declared here with the exact signatures of <windows.h>,
+    // which would otherwise leak its macros (min, max, GetObject, CreateFile, ...) into every user of this header.
+    struct _SECURITY_ATTRIBUTES;
+    
+    extern "C"
+    {
+    #if defined(_WIN64)
+        using BMJsonWin32SizeType = unsigned __int64;
+    #else
+        using BMJsonWin32SizeType = unsigned long;
+    #endif
+        
+        __declspec(dllimport) void* __stdcall CreateFileA(const char* FileName, unsigned long DesiredAccess, unsigned long ShareMode, _SECURITY_ATTRIBUTES* SecurityAttributes,
+            unsigned long CreationDisposition, unsigned long FlagsAndAttributes, void* TemplateFile);
+        __declspec(dllimport) unsigned long __stdcall GetFileSize(void* File, unsigned long* FileSizeHigh);
+        __declspec(dllimport) void* __stdcall CreateFileMappingA(void* File, _SECURITY_ATTRIBUTES* FileMappingAttributes, unsigned long Protect,
+            unsigned long MaximumSizeHigh, unsigned long MaximumSizeLow, const char* Name);
+        __declspec(dllimport) void* __stdcall MapViewOfFile(void* FileMappingObject, unsigned long DesiredAccess, unsigned long FileOffsetHigh,
+            unsigned long FileOffsetLow, BMJsonWin32SizeType NumberOfBytesToMap);
+        __declspec(dllimport) int __stdcall UnmapViewOfFile(const void* BaseAddress);
+        __declspec(dllimport) int __stdcall CloseHandle(void* Object);
+        __declspec(dllimport) unsigned long __stdcall GetLastError();
+    }
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 #define ThrowParserError(...)\
     ThrowError(__VA_ARGS__);\
@@ -182,12 +250,160 @@ namespace BMJson
         JsonValue Value;
     };
 
+    // Monotonic memory resource owning every node of a parsed document.
+    // Deallocation is a no-op, memory is returned when the arena is destroyed and kept for reuse by Reset.
+    // Destroying a document still runs the destructor of every value and releases every reference count, only the
+    // individual frees are saved.
+    class JsonArena final : public std::pmr::memory_resource
+    {
+    public:
+        explicit JsonArena(size_t InitialBlockSize = 64 * 1024) :
+        NextBlockSize(InitialBlockSize)
+        {
+            
+        }
+
+        JsonArena(const JsonArena& Other) = delete;
+        JsonArena& operator=(const JsonArena& Other) = delete;
+
+        // Rewinds to the first block, all previously allocated memory must be unused
+        void Reset()
+        {
+            CurrentBlock = 0;
+            Offset = 0;
+        }
+
+        [[nodiscard]] size_t GetCapacity() const
+        {
+            size_t Capacity{};
+            for(const auto& Block : Blocks)
+            {
+                Capacity += Block.Size;
+            }
+            return Capacity;
+        }
+
+    protected:
+        void* do_allocate(size_t Bytes, size_t Alignment) override
+        {
+            while(CurrentBlock < Blocks.size())
+            {
+                auto& Block = Blocks[CurrentBlock];
+                const uintptr_t Base = reinterpret_cast<uintptr_t>(Block.Data.get());
+                const uintptr_t Aligned = (Base + Offset + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+                
+                if(Aligned + Bytes <= Base + Block.Size)
+                {
+                    Offset = Aligned + Bytes - Base;
+                    return reinterpret_cast<void*>(Aligned);
+                }
+
+                ++CurrentBlock;
+                Offset = 0;
+            }
+
+            // Blocks grow geometrically so the number of upstream allocations stays logarithmic
+            const size_t Size = std::max(NextBlockSize, Bytes + Alignment);
+            NextBlockSize = Size * 2;
+            
+            Blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(Size), Size});
+            CurrentBlock = Blocks.size() - 1;
+            
+            return do_allocate(Bytes, Alignment);
+        }
+
+        void do_deallocate(void*, size_t, size_t) override
+        {
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& Other) const noexcept override
+        {
+            return this == &Other;
+        }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> Data;
+            size_t Size{};
+        };
+        
+        std::vector<Block> Blocks{};
+        size_t CurrentBlock{};
+        size_t Offset{};
+        size_t NextBlockSize{};
+    };
+
+    // Allocator for nodes created with std::allocate_shared, keeps the arena alive as long as a node references it
+    template<typename T>
+    struct JsonArenaAllocator
+    {
+        using value_type = T;
+
+        explicit JsonArenaAllocator(std::shared_ptr<JsonArena> ArenaIn) :
+        Arena(std::move(ArenaIn))
+        {
+            
+        }
+
+        template<typename U>
+        JsonArenaAllocator(const JsonArenaAllocator<U>& Other) :
+        Arena(Other.Arena)
+        {
+            
+        }
+
+        T* allocate(size_t Count)
+        {
+            return static_cast<T*>(Arena->allocate(Count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t)
+        {
+        }
+
+        template<typename U>
+        bool operator==(const JsonArenaAllocator<U>& Other) const
+        {
+            return Arena == Other.Arena;
+        }
+
+        std::shared_ptr<JsonArena> Arena;
+    };
+
+    namespace Detail
+    {
+        // A container does not own the arena its storage lives in, only the shared_ptr node holding it does.
+        // Containers moved out of an arena therefore move their elements to the default resource.
+        inline std::pmr::memory_resource* GetMoveResource(std::pmr::memory_resource* Resource)
+        {
+            return dynamic_cast<JsonArena*>(Resource) ? std::pmr::get_default_resource() : Resource;
+        }
+    }
+
     template<typename T, bool bHasOr = false>
     struct JsonValueWrapper;
-    
+
+    // Containers use polymorphic allocators so parsed documents can place them in a JsonArena.
+    // Copies always use the default resource, moving a container out of an arena moves its elements to the default resource.
     struct JsonObject
     {
         JsonObject() = default;
+        JsonObject(const JsonObject& Other) = default;
+        JsonObject& operator=(const JsonObject& Other) = default;
+        JsonObject& operator=(JsonObject&& Other) = default;
+
+        JsonObject(JsonObject&& Other) :
+        Properties(std::move(Other.Properties), Detail::GetMoveResource(Other.Properties.get_allocator().resource()))
+        {
+            
+        }
+
+        explicit JsonObject(std::pmr::memory_resource* Resource) :
+        Properties(Resource)
+        {
+            
+        }
 
         JsonObject(const TJsonInitList& List)
         {
@@ -203,7 +419,7 @@ namespace BMJson
         JsonValueWrapper<JsonValue> operator[](const std::string& Key);
         JsonValueWrapper<const JsonValue> operator[](const std::string& Key) const;
         
-        std::unordered_map<std::string, JsonValue> Properties{};
+        std::pmr::unordered_map<std::string, JsonValue> Properties{};
         
     private:
         void InitFromList(const TJsonInitList& List)
@@ -219,6 +435,21 @@ namespace BMJson
     struct JsonArray
     {
         JsonArray() = default;
+        JsonArray(const JsonArray& Other) = default;
+        JsonArray& operator=(const JsonArray& Other) = default;
+        JsonArray& operator=(JsonArray&& Other) = default;
+
+        JsonArray(JsonArray&& Other) :
+        Values(std::move(Other.Values), Detail::GetMoveResource(Other.Values.get_allocator().resource()))
+        {
+            
+        }
+
+        explicit JsonArray(std::pmr::memory_resource* Resource) :
+        Values(Resource)
+        {
+            
+        }
 
         JsonArray(const TJsonInitList& List)
         {
@@ -235,7 +466,7 @@ namespace BMJson
         JsonValueWrapper<const JsonValue> operator[](size_t Index) const;
         JsonValueWrapper<JsonValue> AddValue();
         
-        std::vector<JsonValue> Values{};
+        std::pmr::vector<JsonValue> Values{};
         
     private:
         void InitFromList(const TJsonInitList& List)
@@ -496,926 +727,6206 @@ namespace BMJson
     struct JsonToken
     {
         JsonToken() = default;
-        JsonToken(const JsonToken& Other) = default;
-        JsonToken& operator=(const JsonToken& Other) = default;
 
-        JsonToken(JsonTokenType Type, size_t Position, std::string Str) :
+        JsonToken(JsonTokenType Type, size_t Position, std::string_view Value, bool bHasEscapes = false) :
         Type(Type),
+        bHasEscapes(bHasEscapes),
         Position(Position),
-        Value(std::move(Str))
+        Value(Value)
         {
         
         }
 
-        JsonToken(JsonToken&& Other) :
-        Type(Other.Type),
-        Position(Other.Position),
-        Value(std::move(Other.Value))
-        {
-            Other.Type = JsonTokenType::NotSet;
-            Other.Position = 0;
-        }
-
-        JsonToken& operator=(JsonToken&& Other)
-        {
-            if(this != &Other)
-            {
-                Type = Other.Type;
-                Position = Other.Position;
-                Value = std::move(Other.Value);
-                
-                Other.Type = JsonTokenType::NotSet;
-                Other.Position = 0;
-            }
-            return *this;
-        }
-    
-
         JsonTokenType Type{JsonTokenType::NotSet};
+        
+        // String token contains at least one '\\' and must be decoded before use
+        bool bHasEscapes{};
+
+        // Number token holds a double, either written with a fraction/exponent or too large for int64_t
+        bool bIsFloat{};
         size_t Position{};
-        std::string Value{};
+
+        // Slice of the tokenizer input (string tokens exclude the quotes) or a static error message
+        std::string_view Value{};
+
+        // Value of number tokens, converted by the tokenizer
+        union
+        {
+            int64_t Integer;
+            double Float;
+        } Number{};
     };
     
     
-    class JsonTokenizer
+    enum class JsonSimdLevel
     {
-    public:
-        JsonTokenizer() = default;
-        JsonTokenizer(const JsonTokenizer& Other) = default;
-        JsonTokenizer& operator=(const JsonTokenizer& Other) = default;
-        JsonTokenizer(JsonTokenizer&& Other) = default;
-        JsonTokenizer& operator=(JsonTokenizer&& Other) = default;
-
-        void Init(std::string_view InputIn)
-        {
-            Input = InputIn;
-            Position = 0;
-            CurrentToken = {JsonTokenType::NotSet, 0, ""};
-        }
+        Scalar,
+        SSE2,
+        AVX2
+    };
 
-        JsonToken PeekToken()
+    // Best instruction set supported by the running CPU, detected once
+    inline JsonSimdLevel GetJsonSimdLevel()
+    {
+#if BMJSON_X64
+        static const JsonSimdLevel Level = []()
         {
-            if(CurrentToken.Type == JsonTokenType::NotSet)
+#if defined(_MSC_VER) && !defined(__clang__)
+            int CpuInfo[4]{};
+            __cpuidex(CpuInfo, 0, 0);
+            if(CpuInfo[0] >= 7)
             {
-                CurrentToken = NextToken();
+                __cpuidex(CpuInfo, 1, 0);
+                const bool bOsSavesYmm = (CpuInfo[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+                const bool bHasAvx = CpuInfo[2] & (1 << 28);
+                
+                __cpuidex(CpuInfo, 7, 0);
+                if(bOsSavesYmm && bHasAvx && (CpuInfo[1] & (1 << 5)))
+                {
+                    return JsonSimdLevel::AVX2;
+                }
             }
-        
-            return CurrentToken;
-        }
-
-        JsonToken GetToken()
-        {
-            if(CurrentToken.Type == JsonTokenType::NotSet)
+#else
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2"))
             {
-                CurrentToken = NextToken();
+                return JsonSimdLevel::AVX2;
             }
+#endif
+            return JsonSimdLevel::SSE2;
+        }();
         
-            auto Token = CurrentToken;
-            CurrentToken = NextToken();
-
-            return Token;
-        }
+        return Level;
+#else
+        return JsonSimdLevel::Scalar;
+#endif
+    }
 
-        [[nodiscard]] std::string_view GetInput() const
+    namespace Detail
+    {
+        // The four whitespace characters of the JSON grammar, the structural index uses the same set
+        constexpr bool IsJsonWhitespace(char Char)
         {
-            return Input;
+            return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
         }
-
-
-    private:
-        static bool IsValidNumberChar(char c)
+        
+        constexpr uint64_t RepeatByte(uint8_t Byte)
         {
-            return std::isdigit(c) || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+            return 0x0101010101010101ull * Byte;
         }
 
-        static bool IsValidAfterLiteral(char c)
+        // Sets the high bit of every byte of Word equal to Byte, exact for the lowest matching byte
+        constexpr uint64_t MatchBytes(uint64_t Word, uint8_t Byte)
         {
-            return c == '\0' || std::isspace(c) || c == ',' || c == ']' || c == '}';
+            const uint64_t Diff = Word ^ RepeatByte(Byte);
+            return (Diff - RepeatByte(0x01)) & ~Diff & RepeatByte(0x80);
         }
-    
-        JsonToken NextToken()
+        
+        // Returns the first '"' or '\\' in [Begin, End), or End if there is none
+        inline const char* FindQuoteOrBackslash(const char* Begin, const char* End)
         {
-            SkipWhitespace();
-            if(Position >= Input.size())
+#if BMJSON_X64
+            const __m128i Quote = _mm_set1_epi8('"');
+            const __m128i Backslash = _mm_set1_epi8('\\');
+            for(; End - Begin >= 16; Begin += 16)
             {
-                return {JsonTokenType::None, Position, ""};
+                const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Begin));
+                const int Mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(Chunk, Quote), _mm_cmpeq_epi8(Chunk, Backslash)));
+                if(Mask != 0)
+                {
+                    return Begin + std::countr_zero(static_cast<uint32_t>(Mask));
+                }
             }
-
-            const size_t TokenPosition = Position;
-            switch(const char Current = Peek())
+#endif
+            if constexpr(std::endian::native == std::endian::little)
             {
-                case '{': return {JsonTokenType::ObjectStart, TokenPosition, {Get()}};
-                case '}': return {JsonTokenType::ObjectEnd, TokenPosition, {Get()}};
-                case '[': return {JsonTokenType::ArrayStart, TokenPosition, {Get()}};
-                case ']': return {JsonTokenType::ArrayEnd, TokenPosition, {Get()}};
-                case ',': return {JsonTokenType::Comma, TokenPosition, {Get()}};
-                case ':': return {JsonTokenType::Colon, TokenPosition, {Get()}};
-                case 'n': return ParseNull();
-                case '"': return ParseString();
-                case 't' : case 'f': return ParseBoolean();
-                
-                default:
+                for(; End - Begin >= 8; Begin += 8)
                 {
-                    if(IsValidNumberChar(Current))
+                    uint64_t Word;
+                    std::memcpy(&Word, Begin, sizeof(Word));
+                    
+                    const uint64_t Mask = MatchBytes(Word, '"') | MatchBytes(Word, '\\');
+                    if(Mask != 0)
                     {
-                        return ParseNumber();
+                        return Begin + std::countr_zero(Mask) / 8;
                     }
                 }
             }
-
-            return {JsonTokenType::Error, Position, "Invalid token"};
-        }
-        
-        bool ProcessLiteral(const std::string& Literal)
-        {
-            const size_t CurrentPos = Position;
-            const size_t Size = Literal.size();
             
-            if(Input.substr(Position, Size) == Literal)
+            for(; Begin != End; ++Begin)
             {
-                Position += Size;
-                SkipWhitespace();
-                
-                if(IsValidAfterLiteral(Peek()))
-                {
-                    return true;
-                }
+                if(*Begin == '"' || *Begin == '\\') return Begin;
             }
             
-            Position = CurrentPos;
-            return false;
+            return End;
         }
 
-        JsonToken ParseNull()
+        // Decoded character for every simple escape, 'u' marks the unicode escape and 0 an invalid one
+        inline constexpr std::array<char, 256> UnescapeTable = []()
         {
-            JsonToken Token{JsonTokenType::Error, Position, ""};
-            if(ProcessLiteral("null"))
+            std::array<char, 256> Result{};
+            Result['"'] = '"';
+            Result['\\'] = '\\';
+            Result['/'] = '/';
+            Result['b'] = '\b';
+            Result['f'] = '\f';
+            Result['n'] = '\n';
+            Result['r'] = '\r';
+            Result['t'] = '\t';
+            Result['u'] = 'u';
+            return Result;
+        }();
+
+        inline constexpr std::array<int8_t, 256> HexTable = []()
+        {
+            std::array<int8_t, 256> Result{};
+            Result.fill(-1);
+            for(int Digit = 0; Digit < 10; ++Digit) Result['0' + Digit] = static_cast<int8_t>(Digit);
+            for(int Digit = 0; Digit < 6; ++Digit)
             {
-                Token.Value = "null";
-                Token.Type = JsonTokenType::Null;
-                return Token;
+                Result['a' + Digit] = static_cast<int8_t>(10 + Digit);
+                Result['A' + Digit] = static_cast<int8_t>(10 + Digit);
             }
-            
-            Token.Value = "Invalid null format [expected 'null']";
-            return Token;
-        }
-    
-        JsonToken ParseString()
-        {
-            JsonToken Token{JsonTokenType::String, Position, ""};
-            Get();
+            return Result;
+        }();
 
-            for(char Current = Get(); Current != '\0'; Current = Get())
+        // Value of the 4 hex digits at Begin, or -1 if they are not all hex digits
+        inline int32_t DecodeHex4(const char* Begin)
+        {
+            int32_t Result = 0;
+            for(size_t Index = 0; Index < 4; ++Index)
             {
-                if(Current == '\\')
-                {
-                    // Handle escape sequences
-                    Token.Value += Get();
-                    continue;
-                }
-
-                if(Current == '"') break;
-                Token.Value += Current;
+                const int8_t Digit = HexTable[static_cast<uint8_t>(Begin[Index])];
+                if(Digit < 0) return -1;
+                Result = (Result << 4) | Digit;
             }
+            return Result;
+        }
 
-            return Token;
+        constexpr bool IsHighSurrogate(int32_t CodeUnit)
+        {
+            return CodeUnit >= 0xD800 && CodeUnit <= 0xDBFF;
         }
 
-        JsonToken ParseNumber()
+        constexpr bool IsLowSurrogate(int32_t CodeUnit)
         {
-            const size_t Start = Position;
+            return CodeUnit >= 0xDC00 && CodeUnit <= 0xDFFF;
+        }
+
+        // Decodes the \\uXXXX escape (or surrogate pair) starting at the backslash Begin.
+        // Returns the number of consumed characters, 0 if the escape is invalid.
+        inline size_t DecodeUnicodeEscape(const char* Begin, const char* End, uint32_t& CodePoint)
+        {
+            if(End - Begin < 6) return 0;
             
-            auto ProcessDigits = [&]()
+            const int32_t First = DecodeHex4(Begin + 2);
+            if(First < 0 || IsLowSurrogate(First)) return 0;
+            if(!IsHighSurrogate(First))
             {
-                if(std::isdigit(Peek()))
-                {
-                    while(std::isdigit(Peek())) Get();
-                    return true;
-                }
-                return false;
-            };
+                CodePoint = static_cast<uint32_t>(First);
+                return 6;
+            }
+
+            if(End - Begin < 12 || Begin[6] != '\\' || Begin[7] != 'u') return 0;
             
-            if(Peek() == '-') //sign
+            const int32_t Second = DecodeHex4(Begin + 8);
+            if(!IsLowSurrogate(Second)) return 0;
+            
+            CodePoint = 0x10000 + ((static_cast<uint32_t>(First) - 0xD800) << 10) + (static_cast<uint32_t>(Second) - 0xDC00);
+            return 12;
+        }
+
+        inline void AppendUtf8(std::string& Result, uint32_t CodePoint)
+        {
+            if(CodePoint < 0x80)
             {
-                Get();
+                Result += static_cast<char>(CodePoint);
             }
-            
-            if(std::isdigit(Peek()))
+            else if(CodePoint < 0x800)
             {
-                if(Peek() == '0' && std::isdigit(PeekAhead(1))) //leading zeros are not allowed
-                {
-                    return {JsonTokenType::Error, Start, "Invalid number format [leading zeros are not allowed]"};
-                }
-                
-                while(std::isdigit(Peek())) Get();
+                const char Bytes[] = {static_cast<char>(0xC0 | (CodePoint >> 6)), static_cast<char>(0x80 | (CodePoint & 0x3F))};
+                Result.append(Bytes, 2);
+            }
+            else if(CodePoint < 0x10000)
+            {
+                const char Bytes[] = {static_cast<char>(0xE0 | (CodePoint >> 12)), static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)),
+                    static_cast<char>(0x80 | (CodePoint & 0x3F))};
+                Result.append(Bytes, 3);
             }
             else
             {
-                return {JsonTokenType::Error, Start, "Invalid number format [expected digit as first character]"};
+                const char Bytes[] = {static_cast<char>(0xF0 | (CodePoint >> 18)), static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F)),
+                    static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F)), static_cast<char>(0x80 | (CodePoint & 0x3F))};
+                Result.append(Bytes, 4);
             }
-            
-            if(Peek() == '.') //decimal point
+        }
+
+        // Escape letter for every character which can't appear raw in a JSON string, 'u' for the \\u00XX form
+        inline constexpr std::array<char, 256> EscapeTable = []()
+        {
+            std::array<char, 256> Result{};
+            for(size_t Index = 0; Index < 0x20; ++Index) Result[Index] = 'u';
+            Result['"'] = '"';
+            Result['\\'] = '\\';
+            Result['\b'] = 'b';
+            Result['\f'] = 'f';
+            Result['\n'] = 'n';
+            Result['\r'] = 'r';
+            Result['\t'] = 't';
+            return Result;
+        }();
+
+#if BMJSON_X64
+        BMJSON_TARGET_AVX2 inline const char* FindEscapeCharAVX2(const char* Begin, const char* End)
+        {
+            const __m256i Quote = _mm256_set1_epi8('"');
+            const __m256i Backslash = _mm256_set1_epi8('\\');
+            const __m256i MaxControl = _mm256_set1_epi8(0x1F);
+            for(; End - Begin >= 32; Begin += 32)
             {
-                Get();
-                if(!ProcessDigits())
+                const __m256i Chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Begin));
+                const __m256i Control = _mm256_cmpeq_epi8(_mm256_max_epu8(Chunk, MaxControl), MaxControl);
+                const __m256i Special = _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Quote), _mm256_cmpeq_epi8(Chunk, Backslash));
+                const uint32_t Mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(Control, Special)));
+                if(Mask != 0)
                 {
-                    return {JsonTokenType::Error, Start, "Invalid number format [expected digit after decimal point]"};
+                    return Begin + std::countr_zero(Mask);
                 }
             }
+            return Begin;
+        }
+#endif
+        
+        // Returns the first character of [Begin, End) which must be escaped in a JSON string, or End
+        inline const char* FindEscapeChar(const char* Begin, const char* End)
+        {
+#if BMJSON_X64
+            if(End - Begin >= 64 && GetJsonSimdLevel() == JsonSimdLevel::AVX2)
+            {
+                Begin = FindEscapeCharAVX2(Begin, End);
+                if(End - Begin >= 32) return Begin;
+            }
             
-            if(std::tolower(Peek()) == 'e') //exponent
+            const __m128i Quote = _mm_set1_epi8('"');
+            const __m128i Backslash = _mm_set1_epi8('\\');
+            const __m128i MaxControl = _mm_set1_epi8(0x1F);
+            for(; End - Begin >= 16; Begin += 16)
             {
-                Get();
-                if(Peek() == '+' || Peek() == '-')
+                const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Begin));
+                const __m128i Control = _mm_cmpeq_epi8(_mm_max_epu8(Chunk, MaxControl), MaxControl);
+                const __m128i Special = _mm_or_si128(_mm_cmpeq_epi8(Chunk, Quote), _mm_cmpeq_epi8(Chunk, Backslash));
+                const int Mask = _mm_movemask_epi8(_mm_or_si128(Control, Special));
+                if(Mask != 0)
                 {
-                    Get();
+                    return Begin + std::countr_zero(static_cast<uint32_t>(Mask));
                 }
-                
-                if(!ProcessDigits())
+            }
+#endif
+            if constexpr(std::endian::native == std::endian::little)
+            {
+                for(; End - Begin >= 8; Begin += 8)
                 {
-                    return {JsonTokenType::Error, Start, "Invalid number format [expected digit in exponent]"};
+                    uint64_t Word;
+                    std::memcpy(&Word, Begin, sizeof(Word));
+
+                    const uint64_t Control = (Word - RepeatByte(0x20)) & ~Word & RepeatByte(0x80);
+                    const uint64_t Mask = Control | MatchBytes(Word, '"') | MatchBytes(Word, '\\');
+                    if(Mask != 0)
+                    {
+                        return Begin + std::countr_zero(Mask) / 8;
+                    }
                 }
             }
+
+            for(; Begin != End; ++Begin)
+            {
+                if(EscapeTable[static_cast<uint8_t>(*Begin)] != 0) return Begin;
+            }
+
+            return End;
+        }
+
+        // Appends Value as a quoted JSON string, clean runs are copied in bulk
+        inline void AppendEscapedString(std::string& Result, std::string_view Value)
+        {
+            static constexpr char HexDigits[] = "0123456789abcdef";
             
-            SkipWhitespace();
-            if(!IsValidAfterLiteral(Peek()))
+            Result += '"';
+            
+            const char* Current = Value.data();
+            const char* const End = Current + Value.size();
+            for(;;)
             {
-                return {JsonTokenType::Error, Start, "Invalid number format [unexpected character]"};
+                const char* RunEnd = FindEscapeChar(Current, End);
+                Result.append(Current, static_cast<size_t>(RunEnd - Current));
+                if(RunEnd == End) break;
+
+                const uint8_t Char = static_cast<uint8_t>(*RunEnd);
+                const char Escape = EscapeTable[Char];
+                if(Escape == 'u')
+                {
+                    const char Sequence[] = {'\\', 'u', '0', '0', HexDigits[Char >> 4], HexDigits[Char & 0xF]};
+                    Result.append(Sequence, sizeof(Sequence));
+                }
+                else
+                {
+                    const char Sequence[] = {'\\', Escape};
+                    Result.append(Sequence, sizeof(Sequence));
+                }
+                
+                Current = RunEnd + 1;
             }
             
-            return {JsonTokenType::Number, Start, std::string{Input.substr(Start, Position - Start)}};
+            Result += '"';
         }
 
-        JsonToken ParseBoolean()
+        template<std::integral T>
+        void AppendInteger(std::string& Result, T Value)
         {
-            JsonToken Token{JsonTokenType::Error, Position, ""};
+            char Buffer[24];
+            const auto [End, Error] = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+            Result.append(Buffer, End);
+        }
+
+        // Shortest representation that parses back to the same double when Precision is negative,
+        // otherwise fixed notation with Precision digits after the decimal point
+        inline void AppendDouble(std::string& Result, double Value, int Precision)
+        {
+            if(!std::isfinite(Value))
+            {
+                // NaN and infinity have no JSON representation
+                Result += "null";
+                return;
+            }
+
+            static constexpr int MaxPrecision = 64;
+            char Buffer[std::numeric_limits<double>::max_exponent10 + MaxPrecision + 8];
             
-            if(ProcessLiteral("true"))
+            if(Precision >= 0)
             {
-                Token.Value = "true";
-                Token.Type = JsonTokenType::Boolean;
-                return Token;
+                const auto [End, Error] = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value, std::chars_format::fixed, std::min(Precision, MaxPrecision));
+                Result.append(Buffer, End);
+                return;
             }
-            else if(ProcessLiteral("false"))
+
+            const auto [End, Error] = std::to_chars(Buffer, Buffer + sizeof(Buffer), Value);
+            Result.append(Buffer, End);
+
+            // Keep integral doubles parsing back as doubles
+            if(std::find_if(Buffer, End, [](char C) { return C == '.' || C == 'e'; }) == End)
             {
-                Token.Value = "false";
-                Token.Type = JsonTokenType::Boolean;
-                return Token;
+                Result += ".0";
             }
-            
-            Token.Value = "Invalid boolean format [expected 'true' or 'false']";
-            return Token;
         }
-    
-        void SkipWhitespace()
+    }
+
+    // Stage-1 pass over the input which records the position of every token start (structural characters,
+    // opening quotes and the first character of literals and numbers) outside of strings.
+    // The input is processed in 64-byte blocks, each character class being reduced to a 64-bit mask.
+    class JsonStructuralIndex
+    {
+    public:
+        static constexpr size_t BlockSize = 64;
+        
+        JsonStructuralIndex() = default;
+
+        // Returns false if the input is too large to be indexed with 32-bit positions
+        bool Build(std::string_view Input, JsonSimdLevel Level = GetJsonSimdLevel())
         {
-            while (Position < Input.size() && std::isspace(Input[Position]))
+            Positions.clear();
+            if(Input.size() > std::numeric_limits<uint32_t>::max())
             {
-                ++Position;
+                return false;
             }
-        }
-    
-        [[nodiscard]] char Peek() const
-        {
-            return Position < Input.size() ? Input[Position] : '\0';
+            
+            switch(Level)
+            {
+#if BMJSON_X64
+                case JsonSimdLevel::AVX2: BuildAVX2(Input); break;
+                case JsonSimdLevel::SSE2: BuildSSE2(Input); break;
+#endif
+                default: Build<ScalarClassifier>(Input); break;
+            }
+
+            return true;
         }
 
-        [[nodiscard]] char PeekAhead(size_t Offset) const
+        void Clear()
         {
-            const size_t NewPosition = Position + Offset;
-            return NewPosition < Input.size() ? Input[NewPosition] : '\0';
+            Positions.clear();
         }
 
-        char Get()
+        [[nodiscard]] std::span<const uint32_t> GetPositions() const
         {
-            return Position < Input.size() ? Input[Position++] : '\0';
+            return Positions;
         }
-    
-        size_t Position{};
-        std::string_view Input{};
-        JsonToken CurrentToken{};
-    };
-    
-    class Json
-    {
-    public:
-        Json()
+
+    private:
+        struct BlockMasks
         {
-            RootObject = std::make_shared<JsonObject>();
-        }
+            uint64_t Backslash{};
+            uint64_t Quote{};
+            uint64_t Whitespace{};
+            uint64_t Operator{};
+        };
 
-        Json(const Json& Other) :
-        Tokenizer{Other.Tokenizer},
-        CurrentToken{Other.CurrentToken},
-        ErrorMessage{Other.ErrorMessage}
+        struct ScalarClassifier
         {
-            if(Other.RootObject)
+            enum : uint8_t
+            {
+                Backslash = 1,
+                Quote = 2,
+                Whitespace = 4,
+                Operator = 8
+            };
+            
+            static constexpr std::array<uint8_t, 256> Table = []()
             {
-                RootObject = std::make_shared<JsonObject>();
-                *RootObject = *Other.RootObject;
+                std::array<uint8_t, 256> Result{};
+                Result['\\'] = Backslash;
+                Result['"'] = Quote;
+                Result[' '] = Result['\t'] = Result['\n'] = Result['\r'] = Whitespace;
+                Result['{'] = Result['}'] = Result['['] = Result[']'] = Result[','] = Result[':'] = Operator;
+                return Result;
+            }();
+            
+            static BlockMasks Classify(const char* Block)
+            {
+                BlockMasks Masks{};
+                for(size_t Index = 0; Index < BlockSize; ++Index)
+                {
+                    const uint8_t Class = Table[static_cast<uint8_t>(Block[Index])];
+                    const uint64_t Bit = uint64_t{1} << Index;
+                    
+                    if(Class & Backslash) Masks.Backslash |= Bit;
+                    if(Class & Quote) Masks.Quote |= Bit;
+                    if(Class & Whitespace) Masks.Whitespace |= Bit;
+                    if(Class & Operator) Masks.Operator |= Bit;
+                }
+                return Masks;
             }
-        }
-
-        Json(Json&& Other) :
-        Tokenizer{std::move(Other.Tokenizer)},
-        CurrentToken{std::move(Other.CurrentToken)},
-        ErrorMessage{std::move(Other.ErrorMessage)},
-        RootObject{std::move(Other.RootObject)}
-        {
-            Other.Tokenizer.Init("");
-            Other.CurrentToken = {JsonTokenType::NotSet, 0, ""};
-            Other.ErrorMessage.reset();
-        }
+        };
 
-        Json& operator=(const Json& Other)
+#if BMJSON_X64
+        struct SSE2Classifier
         {
-            if(this != &Other)
+            static BlockMasks Classify(const char* Block)
             {
-                Tokenizer = Other.Tokenizer;
-                CurrentToken = Other.CurrentToken;
-                ErrorMessage = Other.ErrorMessage;
-
-                if(Other.RootObject)
+                BlockMasks Masks{};
+                for(size_t Offset = 0; Offset < BlockSize; Offset += 16)
                 {
-                    RootObject = std::make_shared<JsonObject>();
-                    *RootObject = *Other.RootObject;
+                    const __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Block + Offset));
+                    auto Match = [&](char C) { return _mm_cmpeq_epi8(Chunk, _mm_set1_epi8(C)); };
+                    auto ToMask = [&](__m128i Value) { return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(Value))) << Offset; };
+                    
+                    // '[' and ']' differ from '{' and '}' only by bit 0x20
+                    const __m128i Folded = _mm_or_si128(Chunk, _mm_set1_epi8(0x20));
+                    const __m128i Brackets = _mm_or_si128(_mm_cmpeq_epi8(Folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(Folded, _mm_set1_epi8('}')));
+                    
+                    Masks.Backslash |= ToMask(Match('\\'));
+                    Masks.Quote |= ToMask(Match('"'));
+                    Masks.Whitespace |= ToMask(_mm_or_si128(_mm_or_si128(Match(' '), Match('\t')), _mm_or_si128(Match('\n'), Match('\r'))));
+                    Masks.Operator |= ToMask(_mm_or_si128(Brackets, _mm_or_si128(Match(','), Match(':'))));
                 }
+                return Masks;
             }
-            return *this;
-        }
+        };
 
-        Json& operator=(Json&& Other)
+        struct AVX2Classifier
         {
-            if(this != &Other)
+            BMJSON_TARGET_AVX2 static BlockMasks Classify(const char* Block)
             {
-                Tokenizer = std::move(Other.Tokenizer);
-                CurrentToken = std::move(Other.CurrentToken);
-                ErrorMessage = std::move(Other.ErrorMessage);
-                RootObject = std::move(Other.RootObject);
-
-                Other.Tokenizer.Init("");
-                Other.CurrentToken = {JsonTokenType::NotSet, 0, ""};
-                Other.ErrorMessage.reset();
+                BlockMasks Masks{};
+                for(size_t Offset = 0; Offset < BlockSize; Offset += 32)
+                {
+                    const __m256i Chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Block + Offset));
+                    const __m256i Folded = _mm256_or_si256(Chunk, _mm256_set1_epi8(0x20));
+                    
+                    const __m256i Backslash = _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('\\'));
+                    const __m256i Quote = _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('"'));
+                    const __m256i Whitespace = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('\t'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('\r'))));
+                    const __m256i Operator = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(Folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(Folded, _mm256_set1_epi8('}'))),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8(':'))));
+                    
+                    Masks.Backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(Backslash))) << Offset;
+                    Masks.Quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(Quote))) << Offset;
+                    Masks.Whitespace |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(Whitespace))) << Offset;
+                    Masks.Operator |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(Operator))) << Offset;
+                }
+                return Masks;
             }
-            return *this;
-        }
+        };
 
-        Json(const TJsonInitList& List)
+        BMJSON_TARGET_AVX2 void BuildAVX2(std::string_view Input)
         {
-            InitFromList(List);
+            Build<AVX2Classifier>(Input);
         }
 
-        Json& operator=(const TJsonInitList& List)
+        void BuildSSE2(std::string_view Input)
         {
-            InitFromList(List);
-            return *this;
+            Build<SSE2Classifier>(Input);
         }
+#endif
 
-        JsonValueWrapper<JsonValue> operator[](const std::string& Key)
+        // Carry-less prefix xor, every bit becomes the parity of all bits at or below it
+        static uint64_t PrefixXor(uint64_t Bits)
         {
-            if(!RootObject)
-            {
-                RootObject = std::make_shared<JsonObject>();
-            }
-
-            auto& Value = RootObject->Properties[Key];
-            return {Value};
+            Bits ^= Bits << 1;
+            Bits ^= Bits << 2;
+            Bits ^= Bits << 4;
+            Bits ^= Bits << 8;
+            Bits ^= Bits << 16;
+            Bits ^= Bits << 32;
+            return Bits;
         }
 
-        JsonValueWrapper<const JsonValue> operator[](const std::string& Key) const
+        template<typename TClassifier>
+        void Build(std::string_view Input)
         {
-            if(!RootObject) throw std::runtime_error("Root object is null, const access not possible");
-            
-            auto& Value = RootObject->Properties[Key];
-            return {Value};
-        }
+            static constexpr uint64_t OddBits = 0xAAAAAAAAAAAAAAAAull;
 
-        void Reset(bool bCreateRoot = true)
-        {
-            if(bCreateRoot)
+            // State carried between blocks
+            uint64_t NextIsEscaped{};
+            uint64_t InStringCarry{};
+            uint64_t ScalarCarry{};
+
+            Positions.reserve(Input.size() / 8 + 16);
+            
+            for(size_t Base = 0; Base < Input.size(); Base += BlockSize)
             {
-                if(RootObject)
+                const char* Block = Input.data() + Base;
+                
+                // The tail block is padded with whitespace, which never produces a token start
+                alignas(BlockSize) char Padded[BlockSize];
+                if(Input.size() - Base < BlockSize)
+                {
+                    std::memset(Padded, ' ', BlockSize);
+                    std::memcpy(Padded, Block, Input.size() - Base);
+                    Block = Padded;
+                }
+
+                const BlockMasks Masks = TClassifier::Classify(Block);
+
+                // Characters preceded by an odd number of backslashes are escaped
+                uint64_t Escaped = NextIsEscaped;
+                if(Masks.Backslash)
                 {
-                    RootObject->Properties.clear();
+                    const uint64_t PotentialEscape = Masks.Backslash & ~NextIsEscaped;
+                    const uint64_t MaybeEscaped = PotentialEscape << 1;
+                    const uint64_t EscapeAndTerminal = ((MaybeEscaped | OddBits) - PotentialEscape) ^ OddBits;
+                    Escaped = EscapeAndTerminal ^ (Masks.Backslash | NextIsEscaped);
+                    NextIsEscaped = (EscapeAndTerminal & Masks.Backslash) >> 63;
                 }
                 else
                 {
-                    RootObject = std::make_shared<JsonObject>();
+                    NextIsEscaped = 0;
+                }
+
+                // Opening quote and string contents are set, the closing quote is not
+                const uint64_t Quote = Masks.Quote & ~Escaped;
+                const uint64_t InString = PrefixXor(Quote) ^ InStringCarry;
+                InStringCarry = static_cast<uint64_t>(static_cast<int64_t>(InString) >> 63);
+
+                // Literals and numbers only produce a token start on their first character
+                const uint64_t Scalar = ~(Masks.Operator | Masks.Whitespace);
+                const uint64_t NonQuoteScalar = Scalar & ~Masks.Quote;
+                const uint64_t FollowsScalar = (NonQuoteScalar << 1) | ScalarCarry;
+                ScalarCarry = NonQuoteScalar >> 63;
+
+                const uint64_t StringTail = InString ^ Quote;
+                uint64_t Structurals = (Masks.Operator | (Scalar & ~FollowsScalar)) & ~StringTail;
+
+                const size_t Count = static_cast<size_t>(std::popcount(Structurals));
+                const size_t Offset = Positions.size();
+                Positions.resize(Offset + Count);
+                
+                uint32_t* Output = Positions.data() + Offset;
+                while(Structurals)
+                {
+                    *Output++ = static_cast<uint32_t>(Base + std::countr_zero(Structurals));
+                    Structurals &= Structurals - 1;
                 }
             }
-            
-            Tokenizer.Init("");
-            ErrorMessage.reset();
-            CurrentToken = {JsonTokenType::NotSet, 0, ""};
         }
+        
+        std::vector<uint32_t> Positions{};
+    };
+    
+    
+    class JsonTokenizer
+    {
+    public:
+        JsonTokenizer() = default;
+        JsonTokenizer(const JsonTokenizer& Other) = default;
+        JsonTokenizer& operator=(const JsonTokenizer& Other) = default;
+        JsonTokenizer(JsonTokenizer&& Other) = default;
+        JsonTokenizer& operator=(JsonTokenizer&& Other) = default;
 
-        void Parse(std::string_view Input)
+        // When an index built from the same input is given, whitespace is skipped by jumping to the next token start
+        void Init(std::string_view InputIn, const JsonStructuralIndex* Index = nullptr)
         {
-            Tokenizer.Init(Input);
-            ErrorMessage.reset();
-            
-            RootObject = ParseObject();
+            Input = InputIn;
+            Position = 0;
+            CurrentToken = {JsonTokenType::NotSet, 0, ""};
+
+            Structurals = Index ? Index->GetPositions() : std::span<const uint32_t>{};
+            NextStructural = 0;
+            bUseStructurals = Index != nullptr;
         }
 
-        [[nodiscard]] std::string Serialize(bool bPretty) const
+        const JsonToken& PeekToken()
         {
-            std::string Result;
-            if(!RootObject) return Result;
-
-            SerializeObject(*RootObject, Result, bPretty, 0);
-            return Result;
-        }
+            if(CurrentToken.Type == JsonTokenType::NotSet)
+            {
+                CurrentToken = NextToken();
+            }
         
-        [[nodiscard]] bool HasError() const
-        {
-            return ErrorMessage.has_value();
+            return CurrentToken;
         }
 
-        [[nodiscard]] std::string_view GetError() const
+        JsonToken GetToken()
         {
-            if(ErrorMessage.has_value())
+            if(CurrentToken.Type == JsonTokenType::NotSet)
             {
-                return *ErrorMessage;
+                CurrentToken = NextToken();
             }
-            return "";
+        
+            const JsonToken Token = CurrentToken;
+            CurrentToken = NextToken();
+
+            return Token;
         }
 
-        [[nodiscard]] const std::shared_ptr<JsonObject>& GetRootObject() const
+        [[nodiscard]] std::string_view GetInput() const
         {
-            return RootObject;
+            return Input;
         }
 
-    private:
-        void InitFromList(const TJsonInitList& List)
+        // Reads the single token starting at or after Offset without buffering the next one, Offset is moved past it.
+        // Intended for random access into the input, the structural index is not used.
+        JsonToken ReadToken(size_t& Offset)
         {
-            if(!RootObject)
-            {
-                RootObject = std::make_shared<JsonObject>();
-            }
-
-            *RootObject = List;
+            Position = Offset;
+            CurrentToken = {JsonTokenType::NotSet, 0, ""};
+            
+            const bool bUsedStructurals = bUseStructurals;
+            bUseStructurals = false;
+            const JsonToken Token = NextToken();
+            bUseStructurals = bUsedStructurals;
+            
+            Offset = Position;
+            return Token;
         }
-        
-        void Peek()
+
+        // Continues tokenizing from Offset, which must be the start of a token or whitespace
+        void Seek(size_t Offset)
         {
-            UpdateToken(true);
+            Position = Offset;
+            CurrentToken = {JsonTokenType::NotSet, 0, ""};
+            NextStructural = static_cast<size_t>(std::lower_bound(Structurals.begin(), Structurals.end(), Offset) - Structurals.begin());
         }
 
-        void Consume()
+        // Builds the error message for Token, quoting the surrounding input
+        [[nodiscard]] std::string FormatError(const JsonToken& Token, std::string_view Message) const
         {
-            UpdateToken(false);
+            std::string ErrorLocation;
+            if(Token.Position >= Input.size())
+            {
+                ErrorLocation = "Error position out of bounds";
+            }
+            else
+            {
+                static constexpr size_t MaxErrorLocation = 50;
+                    
+                const size_t Start = Token.Position >= MaxErrorLocation ? Token.Position - MaxErrorLocation : 0;
+                const size_t Diff = Token.Position - Start;
+                const size_t End = std::min<size_t>(Token.Position + MaxErrorLocation + Diff, Input.size());
+                
+                ErrorLocation = std::string(Input.substr(Start, End - Start));
+                if(Diff > 0)
+                {
+                    ErrorLocation = std::string(ErrorLocation.substr(0, Diff)) + " *ERROR*--> " + std::string(ErrorLocation.substr(Diff));
+                }
+            }
+            
+            const std::string_view TokeValue = Token.Type == JsonTokenType::Error ? "Tokenization Error" : Token.Value;
+            return std::format("Error at position {}[{}]: {} \nError Reason: {}", Token.Position, TokeValue, ErrorLocation, Message);
         }
 
-        void UpdateToken(bool bPeak)
+        // Materializes the value of a string token, decoding escape sequences if needed
+        [[nodiscard]] static std::string DecodeString(const JsonToken& Token)
         {
-            CurrentToken = bPeak ? Tokenizer.PeekToken() : Tokenizer.GetToken();
-            if(CurrentToken.Type == JsonTokenType::Error)
+            if(!Token.bHasEscapes)
             {
-                ThrowError(CurrentToken, CurrentToken.Value);
+                return std::string{Token.Value};
             }
-        }
 
-        //Serialization
-        void SerializeValue(const JsonValue& Value, std::string& Result, bool bPretty, size_t Depth) const;
-        void SerializeArray(const JsonArray& Array, std::string& Result, bool bPretty, size_t Depth) const;
-        void SerializeObject(const JsonObject& Object, std::string& Result, bool bPretty, size_t Depth) const;
+            std::string Result;
+            Result.reserve(Token.Value.size());
 
-        //Deserialization
-        JsonValue ParseValue();
-        std::shared_ptr<JsonArray> ParseArray();
-        std::shared_ptr<JsonObject> ParseObject();
-        
-        void ThrowError(const JsonToken& Token, const std::string& message);
-    
-    
-        JsonTokenizer Tokenizer;
-        JsonToken CurrentToken{};
-        std::optional<std::string> ErrorMessage{}; 
-        std::shared_ptr<JsonObject> RootObject;
-    };
+            // Copy the unescaped runs between backslashes in bulk, escapes were validated by the tokenizer
+            const char* Current = Token.Value.data();
+            const char* const End = Current + Token.Value.size();
+            while(Current != End)
+            {
+                const char* RunEnd = Detail::FindQuoteOrBackslash(Current, End);
+                Result.append(Current, RunEnd);
+                if(RunEnd == End || End - RunEnd < 2) break;
 
-    inline void Json::SerializeValue(const JsonValue& Value, std::string& Result, bool bPretty, size_t Depth) const
-    {
-        if(HasType<int64_t>(Value))
-        {
-            auto& Number = std::get<int64_t>(Value);
-            Result = std::to_string(Number);
-        }
-        else if(HasType<double>(Value))
-        {
-            auto& Number = std::get<double>(Value);
-            Result = std::to_string(Number);
-        }
-        else if(HasType<nullptr_t>(Value))
-        {
-           Result = "null";
-        }
-        else if(HasType<bool>(Value))
-        {
-            auto& Bool = std::get<bool>(Value);
-            Result = Bool ? "true" : "false";
-        }
-        else if(HasType<std::string>(Value))
-        {
-            auto& String = std::get<std::string>(Value);
-            Result = "\"" + String + "\"";
+                const char Escape = Detail::UnescapeTable[static_cast<uint8_t>(RunEnd[1])];
+                if(Escape == 'u')
+                {
+                    uint32_t CodePoint{};
+                    const size_t Length = Detail::DecodeUnicodeEscape(RunEnd, End, CodePoint);
+                    if(Length == 0) break;
+                    
+                    Detail::AppendUtf8(Result, CodePoint);
+                    Current = RunEnd + Length;
+                }
+                else
+                {
+                    Result += Escape;
+                    Current = RunEnd + 2;
+                }
+            }
+
+            return Result;
         }
-        else if(HasType<JsonArray>(Value))
+
+
+    private:
+        static bool IsValidNumberChar(char c)
         {
-            SerializeArray(*std::get<std::shared_ptr<JsonArray>>(Value), Result, bPretty, Depth + 1);
+            return std::isdigit(c) || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
         }
-        else if(HasType<JsonObject>(Value))
+
+        static bool IsValidAfterLiteral(char c)
         {
-            SerializeObject(*std::get<std::shared_ptr<JsonObject>>(Value), Result, bPretty, Depth + 1);
+            return c == '\0' || Detail::IsJsonWhitespace(c) || c == ',' || c == ']' || c == '}';
         }
-    }
-
-    inline void Json::SerializeArray(const JsonArray& Array, std::string& Result, bool bPretty, size_t Depth) const
-    {
-        Result += '[';
-
-        size_t Written{};
-        for(const auto& Value : Array.Values)
+    
+        JsonToken NextToken()
         {
-            if(Written > 0)
+            if(bUseStructurals)
             {
-                Result += ",";
+                SkipToNextStructural();
             }
-
-            if(bPretty)
+            else
+            {
+                SkipWhitespace();
+            }
+            
+            if(Position >= Input.size())
             {
-                Result += "\n";
-                Result += std::string(Depth + 1, '\t');
+                return {JsonTokenType::None, Position, ""};
             }
 
-            std::string ValueString;
-            SerializeValue(Value, ValueString, bPretty, Depth);
-            Result += ValueString;
+            const size_t TokenPosition = Position;
+            switch(const char Current = Peek())
+            {
+                case '{': return {JsonTokenType::ObjectStart, TokenPosition, Input.substr(Position++, 1)};
+                case '}': return {JsonTokenType::ObjectEnd, TokenPosition, Input.substr(Position++, 1)};
+                case '[': return {JsonTokenType::ArrayStart, TokenPosition, Input.substr(Position++, 1)};
+                case ']': return {JsonTokenType::ArrayEnd, TokenPosition, Input.substr(Position++, 1)};
+                case ',': return {JsonTokenType::Comma, TokenPosition, Input.substr(Position++, 1)};
+                case ':': return {JsonTokenType::Colon, TokenPosition, Input.substr(Position++, 1)};
+                case 'n': return ParseNull();
+                case '"': return ParseString();
+                case 't' : case 'f': return ParseBoolean();
+                
+                default:
+                {
+                    if(IsValidNumberChar(Current))
+                    {
+                        return ParseNumber();
+                    }
+                }
+            }
 
-            ++Written;
+            return {JsonTokenType::Error, Position, "Invalid token"};
         }
-
-        if(bPretty && Result.size() > 1)
+        
+        bool ProcessLiteral(std::string_view Literal)
         {
-            Result += "\n";
-            Result += std::string(Depth, '\t');
+            const size_t CurrentPos = Position;
+            const size_t Size = Literal.size();
+            
+            if(Input.substr(Position, Size) == Literal)
+            {
+                Position += Size;
+                SkipWhitespace();
+                
+                if(IsValidAfterLiteral(Peek()))
+                {
+                    return true;
+                }
+            }
+            
+            Position = CurrentPos;
+            return false;
         }
-        
-        Result += "]";
-    }
-
-    inline void Json::SerializeObject(const JsonObject& Object, std::string& Result, bool bPretty, size_t Depth) const
-    {
-        Result += '{';
 
-        size_t Written{};
-        for(const auto& [Key, Value] : Object.Properties)
+        JsonToken ParseNull()
         {
-            if(Written > 0)
+            JsonToken Token{JsonTokenType::Error, Position, ""};
+            if(ProcessLiteral("null"))
             {
-                Result += ",";
+                Token.Value = Input.substr(Token.Position, 4);
+                Token.Type = JsonTokenType::Null;
+                return Token;
             }
+            
+            Token.Value = "Invalid null format [expected 'null']";
+            return Token;
+        }
+    
+        JsonToken ParseString()
+        {
+            JsonToken Token{JsonTokenType::String, Position, ""};
+            Get();
 
-            std::string Separator = " ";
-            if(bPretty)
+            const char* const Begin = Input.data();
+            const char* const End = Begin + Input.size();
+            const char* Current = Begin + Position;
+            
+            // Jump between quotes and backslashes, the characters in between never need inspection
+            for(Current = Detail::FindQuoteOrBackslash(Current, End); Current != End && *Current != '"'; Current = Detail::FindQuoteOrBackslash(Current, End))
             {
-                Result += "\n";
-                Result += std::string(Depth + 1, '\t');
+                // Escape sequences are validated here but kept raw and decoded on demand
+                Token.bHasEscapes = true;
+                if(End - Current < 2) 
+                {
+                    Current = End;
+                    break;
+                }
 
-                if(HasType<JsonObject>(Value) || HasType<JsonArray>(Value))
+                const char Escape = Detail::UnescapeTable[static_cast<uint8_t>(Current[1])];
+                if(Escape == 'u')
+                {
+                    uint32_t CodePoint{};
+                    const size_t Length = Detail::DecodeUnicodeEscape(Current, End, CodePoint);
+                    if(Length == 0)
+                    {
+                        Position = static_cast<size_t>(Current - Begin);
+                        return {JsonTokenType::Error, Position, "Invalid string format [invalid unicode escape]"};
+                    }
+                    Current += Length;
+                }
+                else if(Escape == '\0')
+                {
+                    Position = static_cast<size_t>(Current - Begin);
+                    return {JsonTokenType::Error, Position, "Invalid string format [invalid escape sequence]"};
+                }
+                else
                 {
-                    Separator = "\n" + std::string(Depth + 1, '\t');
+                    Current += 2;
                 }
             }
 
-            std::string ValueString;
-            SerializeValue(Value, ValueString, bPretty, Depth);
-
-            Result += std::format("\"{}\":{}{}", Key, Separator, ValueString);
-            ++Written;
-        }
+            if(Current == End)
+            {
+                Position = Input.size();
+                return {JsonTokenType::Error, Token.Position, "Invalid string format [missing closing quote]"};
+            }
 
-        if(bPretty && Result.size() > 1)
-        {
-            Result += "\n";
-            Result += std::string(Depth, '\t');
+            Token.Value = Input.substr(Position, static_cast<size_t>(Current - Begin) - Position);
+            Position = static_cast<size_t>(Current - Begin) + 1;
+            return Token;
         }
 
-        Result += "}";
-    }
-
-    inline JsonValue Json::ParseValue()
-    {
-        Peek();
-        switch(CurrentToken.Type)
+        JsonToken ParseNumber()
         {
-            case JsonTokenType::ObjectStart:
+            const size_t Start = Position;
+            
+            auto IsDigit = [](char C)
             {
-                return ParseObject();
-            }
-            case JsonTokenType::ArrayStart:
+                return C >= '0' && C <= '9';
+            };
+            
+            auto ProcessDigits = [&]()
             {
-                return ParseArray();
-            }
-            case JsonTokenType::String:
+                if(IsDigit(Peek()))
+                {
+                    while(IsDigit(Peek())) ++Position;
+                    return true;
+                }
+                return false;
+            };
+
+            const bool bNegative = Peek() == '-';
+            if(bNegative) //sign
             {
-                Consume();
-                return CurrentToken.Value;
+                Get();
             }
-            case JsonTokenType::Number:
+
+            // The integer part is accumulated while it is validated, it can only wrap past 18 digits
+            uint64_t Mantissa{};
+            const size_t DigitsStart = Position;
+            if(IsDigit(Peek()))
             {
-                auto IsFloat = [&]()
-                {
-                    return CurrentToken.Value.find('.') != std::string::npos || CurrentToken.Value.find('e') != std::string::npos;
-                };
-                
-                Consume();
-                if(IsFloat())
+                if(Peek() == '0' && IsDigit(PeekAhead(1))) //leading zeros are not allowed
                 {
-                    return std::stod(CurrentToken.Value);
+                    return {JsonTokenType::Error, Start, "Invalid number format [leading zeros are not allowed]"};
                 }
-                else
+                
+                for(; IsDigit(Peek()); ++Position)
                 {
-                    return std::stoll(CurrentToken.Value);
+                    Mantissa = Mantissa * 10 + static_cast<uint64_t>(Input[Position] - '0');
                 }
             }
-            case JsonTokenType::Null:
+            else
             {
-                Consume();
-                return nullptr;
+                return {JsonTokenType::Error, Start, "Invalid number format [expected digit as first character]"};
             }
-            case JsonTokenType::Boolean:
+
+            const size_t IntegerDigits = Position - DigitsStart;
+            bool bIsFloat = false;
+            
+            size_t FractionStart = Position;
+            size_t FractionEnd = Position;
+            if(Peek() == '.') //decimal point
             {
-                Consume();
-                return CurrentToken.Value == "true";
+                Get();
+                bIsFloat = true;
+                FractionStart = Position;
+                if(!ProcessDigits())
+                {
+                    return {JsonTokenType::Error, Start, "Invalid number format [expected digit after decimal point]"};
+                }
+                FractionEnd = Position;
             }
-            default:;
-        }
-
-        ThrowParserError(CurrentToken, std::format("Unexpected token while parsing value: {}", CurrentToken.Value));
-    }
-
-    inline std::shared_ptr<JsonArray> Json::ParseArray()
-    {
-        {
-            Consume();
-            if(CurrentToken.Type != JsonTokenType::ArrayStart)
+            
+            bool bNegativeExponent = false;
+            size_t ExponentStart = Position;
+            if(Peek() == 'e' || Peek() == 'E') //exponent
             {
-                ThrowParserError(CurrentToken, "Expected '['");
+                Get();
+                bIsFloat = true;
+                if(Peek() == '+' || Peek() == '-')
+                {
+                    bNegativeExponent = Get() == '-';
+                }
+                
+                ExponentStart = Position;
+                if(!ProcessDigits())
+                {
+                    return {JsonTokenType::Error, Start, "Invalid number format [expected digit in exponent]"};
+                }
+            }
+            
+            const size_t NumberEnd = Position;
+            SkipWhitespace();
+            if(!IsValidAfterLiteral(Peek()))
+            {
+                return {JsonTokenType::Error, Start, "Invalid number format [unexpected character]"};
             }
 
-            Peek();
-            std::shared_ptr<JsonArray> Result = std::make_shared<JsonArray>();
-            auto& Values = Result->Values;
-
-            if(CurrentToken.Type == JsonTokenType::ArrayEnd)
+            JsonToken Token{JsonTokenType::Number, Start, Input.substr(Start, NumberEnd - Start)};
+            if(!bIsFloat && IntegerDigits <= 18)
             {
-                Consume();
-                return Result;
+                Token.Number.Integer = bNegative ? -static_cast<int64_t>(Mantissa) : static_cast<int64_t>(Mantissa);
+                return Token;
             }
             
-            for(;; Peek())
+            const char* const First = Token.Value.data();
+            const char* const Last = First + Token.Value.size();
+            if(!bIsFloat)
             {
-                auto Value = ParseValue();
-                if(HasError()) return {};
-                
-                Values.push_back(std::move(Value));
-
-                Consume();
-                if(CurrentToken.Type != JsonTokenType::Comma && CurrentToken.Type != JsonTokenType::ArrayEnd)
+                if(std::from_chars(First, Last, Token.Number.Integer).ec == std::errc{})
                 {
-                    ThrowParserError(CurrentToken, "Expected ',' or ']'");
+                    return Token;
                 }
 
-                if(CurrentToken.Type == JsonTokenType::ArrayEnd) break;
+                // Integers outside of the int64_t range are stored as doubles
             }
 
-            return Result;
-        }
-    }
+            Token.bIsFloat = true;
+            if(std::from_chars(First, Last, Token.Number.Float).ec == std::errc::result_out_of_range)
+            {
+                // The decimal exponent of the leading significant digit tells whether the magnitude is below 1.
+                // Underflow rounds to zero, overflow can't be represented.
+                int64_t Magnitude = std::numeric_limits<int32_t>::min();
+                for(size_t Index = DigitsStart; Index < DigitsStart + IntegerDigits; ++Index)
+                {
+                    if(Input[Index] != '0')
+                    {
+                        Magnitude = static_cast<int64_t>(DigitsStart + IntegerDigits - Index) - 1;
+                        break;
+                    }
+                }
+                for(size_t Index = FractionStart; Index < FractionEnd && Magnitude == std::numeric_limits<int32_t>::min(); ++Index)
+                {
+                    if(Input[Index] != '0')
+                    {
+                        Magnitude = -static_cast<int64_t>(Index - FractionStart) - 1;
+                    }
+                }
 
-    inline std::shared_ptr<JsonObject> Json::ParseObject()
-    {
-        Consume();
-        if(CurrentToken.Type != JsonTokenType::ObjectStart)
-        {
-            ThrowParserError(CurrentToken, "Expected '{'");
+                int64_t Exponent = 0;
+                for(size_t Index = ExponentStart; Index < NumberEnd && Exponent < std::numeric_limits<int32_t>::max(); ++Index)
+                {
+                    Exponent = Exponent * 10 + (Input[Index] - '0');
+                }
+                
+                if(Magnitude + (bNegativeExponent ? -Exponent : Exponent) >= 0)
+                {
+                    return {JsonTokenType::Error, Start, "Invalid number format [number out of range]"};
+                }
+                
+                Token.Number.Float = bNegative ? -0.0 : 0.0;
+            }
+            
+            return Token;
         }
 
-        Peek();
-        std::shared_ptr<JsonObject> Result = std::make_shared<JsonObject>();
-
-        if(CurrentToken.Type == JsonTokenType::ObjectEnd)
-        {
-            Consume();
-            return Result;
-        }
-        
-        for(;; Peek())
+        JsonToken ParseBoolean()
         {
-            if(CurrentToken.Type != JsonTokenType::String)
+            JsonToken Token{JsonTokenType::Error, Position, ""};
+            
+            if(ProcessLiteral("true"))
             {
-                ThrowParserError(CurrentToken, "Expected string key");
+                Token.Value = Input.substr(Token.Position, 4);
+                Token.Type = JsonTokenType::Boolean;
+                return Token;
             }
-
-            // Get the key
-            Consume();
-            auto Key = CurrentToken.Value;
-
-            // Get the colon
-            Consume();
-            if(CurrentToken.Type != JsonTokenType::Colon)
+            else if(ProcessLiteral("false"))
             {
-                ThrowParserError(CurrentToken, "Expected ':'");
+                Token.Value = Input.substr(Token.Position, 5);
+                Token.Type = JsonTokenType::Boolean;
+                return Token;
             }
-
-            // Parse the value
-            auto Value = ParseValue();
-            if(HasError()) return {};
-                
-            Result->Properties.emplace(std::move(Key), std::move(Value));
-
-            Consume();
-            if(CurrentToken.Type != JsonTokenType::Comma && CurrentToken.Type != JsonTokenType::ObjectEnd)
+            
+            Token.Value = "Invalid boolean format [expected 'true' or 'false']";
+            return Token;
+        }
+    
+        void SkipToNextStructural()
+        {
+            while(NextStructural < Structurals.size() && Structurals[NextStructural] < Position)
             {
-                ThrowParserError(CurrentToken, "Expected ',' or '}'");
+                ++NextStructural;
             }
 
-            if(CurrentToken.Type == JsonTokenType::ObjectEnd) break;
-        }
-
-        return Result;
-    }
-
-    inline void Json::ThrowError(const JsonToken& Token, const std::string& message)
-    {
-        if(HasError()) return;
-            
-        std::string_view Input = Tokenizer.GetInput();
-        std::string ErrorLocation;
-        if(Token.Position >= Input.size())
-        {
-            ErrorLocation = "Error position out of bounds";
+            Position = NextStructural < Structurals.size() ? Structurals[NextStructural++] : Input.size();
         }
-        else
+        
+        void SkipWhitespace()
         {
-            static constexpr size_t MaxErrorLocation = 50;
-                
-            const size_t Start = Token.Position >= MaxErrorLocation ? Token.Position - MaxErrorLocation : 0;
-            const size_t Diff = Token.Position - Start;
-            const size_t End = std::min<size_t>(Token.Position + MaxErrorLocation + Diff, Input.size());
-            
-            ErrorLocation = std::string(Input.substr(Start, End - Start));
-            if(Diff > 0)
+            while (Position < Input.size() && Detail::IsJsonWhitespace(Input[Position]))
             {
-                ErrorLocation = std::string(ErrorLocation.substr(0, Diff)) + " *ERROR*--> " + std::string(ErrorLocation.substr(Diff));
+                ++Position;
             }
         }
-        
-        const std::string TokeValue = Token.Type == JsonTokenType::Error ? "Tokenization Error" : Token.Value;
-        ErrorMessage = std::format("Error at position {}[{}]: {} \nError Reason: {}", Token.Position, TokeValue, ErrorLocation, message);
-    }
     
+        [[nodiscard]] char Peek() const
+        {
+            return Position < Input.size() ? Input[Position] : '\0';
+        }
 
-    template<typename T>
-    bool HasType(const JsonValue& Value)
-    {
-        using TType = typename TJsonValueTypeConverter<T>::Type;
-        return std::holds_alternative<TType>(Value);
-    }
+        [[nodiscard]] char PeekAhead(size_t Offset) const
+        {
+            const size_t NewPosition = Position + Offset;
+            return NewPosition < Input.size() ? Input[NewPosition] : '\0';
+        }
+
+        char Get()
+        {
+            return Position < Input.size() ? Input[Position++] : '\0';
+        }
     
-    template<typename T>
-    bool HasField(JsonObject& JsonObject, const std::string& Key)
+        size_t Position{};
+        std::string_view Input{};
+        JsonToken CurrentToken{};
+
+        std::span<const uint32_t> Structurals{};
+        size_t NextStructural{};
+        bool bUseStructurals{};
+    };
+    
+    // Read-only mapping of a whole file, the content is paged in on demand instead of being copied into memory
+    class JsonMappedFile
     {
-        const auto It = JsonObject.Properties.find(Key);
-        if(It != JsonObject.Properties.end())
+    public:
+        JsonMappedFile() = default;
+
+        JsonMappedFile(const JsonMappedFile& Other) = delete;
+        JsonMappedFile& operator=(const JsonMappedFile& Other) = delete;
+
+        JsonMappedFile(JsonMappedFile&& Other) noexcept :
+        Data(std::exchange(Other.Data, nullptr)),
+        Size(std::exchange(Other.Size, 0)),
+        ErrorMessage(std::move(Other.ErrorMessage))
         {
-            if constexpr(std::is_same_v<T, void>)
+            
+        }
+
+        JsonMappedFile& operator=(JsonMappedFile&& Other) noexcept
+        {
+            if(this != &Other)
+            {
+                Close();
+                Data = std::exchange(Other.Data, nullptr);
+                Size = std::exchange(Other.Size, 0);
+                ErrorMessage = std::move(Other.ErrorMessage);
+            }
+            return *this;
+        }
+
+        ~JsonMappedFile()
+        {
+            Close();
+        }
+
+        // Maps the file for sequential reading, returns false and sets the error if it cannot be opened or mapped
+        bool Open(const std::string& Path)
+        {
+            Close();
+            ErrorMessage.reset();
+            
+#if defined(_WIN32)
+            // Values of GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, PAGE_READONLY and FILE_MAP_READ
+            constexpr unsigned long GenericRead = 0x80000000ul;
+            constexpr unsigned long FileShareRead = 0x1;
+            constexpr unsigned long OpenExisting = 3;
+            constexpr unsigned long FileFlagSequentialScan = 0x08000000ul;
+            constexpr unsigned long PageReadOnly = 0x2;
+            constexpr unsigned long FileMapRead = 0x4;
+            constexpr unsigned long InvalidFileSize = 0xFFFFFFFFul;
+            constexpr unsigned long NoError = 0;
+            void* const InvalidHandle = reinterpret_cast<void*>(static_cast<intptr_t>(-1));
+            
+            void* const File = ::CreateFileA(Path.c_str(), GenericRead, FileShareRead, nullptr, OpenExisting, FileFlagSequentialScan, nullptr);
+            if(File == InvalidHandle)
+            {
+                return Fail(Path, std::format("error {}", ::GetLastError()));
+            }
+
+            unsigned long SizeHigh{};
+            const unsigned long SizeLow = ::GetFileSize(File, &SizeHigh);
+            if(SizeLow == InvalidFileSize && ::GetLastError() != NoError)
+            {
+                const unsigned long Error = ::GetLastError();
+                ::CloseHandle(File);
+                return Fail(Path, std::format("error {}", Error));
+            }
+            const uint64_t FileSize = (static_cast<uint64_t>(SizeHigh) << 32) | SizeLow;
+
+            // Empty files cannot be mapped
+            if(FileSize > 0)
+            {
+                void* const Mapping = ::CreateFileMappingA(File, nullptr, PageReadOnly, 0, 0, nullptr);
+                void* View = Mapping ? ::MapViewOfFile(Mapping, FileMapRead, 0, 0, 0) : nullptr;
+                const unsigned long Error = ::GetLastError();
+                
+                if(Mapping) ::CloseHandle(Mapping);
+                ::CloseHandle(File);
+                
+                if(!View)
+                {
+                    return Fail(Path, std::format("error {}", Error));
+                }
+                
+                Data = static_cast<const char*>(View);
+                Size = static_cast<size_t>(FileSize);
+                return true;
+            }
+            
+            ::CloseHandle(File);
+#else
+            const int File = ::open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(File < 0)
+            {
+                return Fail(Path, std::strerror(errno));
+            }
+
+            struct stat Info{};
+            if(::fstat(File, &Info) != 0)
+            {
+                const int Error = errno;
+                ::close(File);
+                return Fail(Path, std::strerror(Error));
+            }
+
+            // Empty files cannot be mapped
+            if(Info.st_size > 0)
             {
+                const size_t FileSize = static_cast<size_t>(Info.st_size);
+                void* Mapping = ::mmap(nullptr, FileSize, PROT_READ, MAP_PRIVATE, File, 0);
+                const int Error = errno;
+                ::close(File);
+                
+                if(Mapping == MAP_FAILED)
+                {
+                    return Fail(Path, std::strerror(Error));
+                }
+
+                // Parsing reads front to back, start reading ahead right away
+                ::madvise(Mapping, FileSize, MADV_SEQUENTIAL);
+                ::madvise(Mapping, FileSize, MADV_WILLNEED);
+                
+                Data = static_cast<const char*>(Mapping);
+                Size = FileSize;
                 return true;
             }
-            else
+            
+            ::close(File);
+#endif
+            return true;
+        }
+
+        void Close()
+        {
+            if(Data)
             {
-                return HasType<T>(It->second);
+#if defined(_WIN32)
+                ::UnmapViewOfFile(Data);
+#else
+                ::munmap(const_cast<char*>(Data), Size);
+#endif
             }
+            
+            Data = nullptr;
+            Size = 0;
         }
 
-        return false;
-    }
+        // Valid until the file is closed
+        [[nodiscard]] std::string_view GetData() const
+        {
+            return {Data, Size};
+        }
 
-    template<typename T>
-    bool HasField(const JsonArray& JsonArray, size_t Index)
-    {
-        if(Index >= JsonArray.Values.size()) return false;
-        if constexpr(std::is_same_v<T, void>)
+        [[nodiscard]] bool HasError() const
         {
-            return true;
+            return ErrorMessage.has_value();
         }
-        else
+
+        [[nodiscard]] std::string_view GetError() const
         {
-            return HasType<T>(JsonArray.Values[Index]);
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
         }
-    }
 
-    template<typename T>
-    bool HasField(const Json& JsonParser, const std::string& Key)
-    {
-        if(!JsonParser.GetRootObject()) return false;
-        return HasField<T>(*JsonParser.GetRootObject(), Key);
-    }
+    private:
+        bool Fail(const std::string& Path, std::string_view Reason)
+        {
+            ErrorMessage = std::format("Unable to map file {}: {}", Path, Reason);
+            return false;
+        }
+        
+        const char* Data{};
+        size_t Size{};
+        std::optional<std::string> ErrorMessage{};
+    };
     
+    struct JsonParseOptions
+    {
+        // Build a JsonStructuralIndex before parsing so the tokenizer jumps between token starts
+        bool bUseStructuralIndex{false};
+
+        // Allocate the parsed containers from a JsonArena owned by the document, reused by the next Parse call
+        // once no container of the previous document is referenced anymore
+        bool bUseArena{false};
+
+        // Deeper documents are rejected with an error, which also bounds the recursion of the compact and tape parsers.
+        // Json parses any depth iteratively, but its containers are still destroyed and serialized recursively.
+        size_t MaxDepth{1024};
+
+        // Arena shared by several documents, used instead of the document's own one. It is never reset by Parse,
+        // the owner resets it once none of the documents allocated from it are referenced anymore.
+        std::shared_ptr<JsonArena> SharedArena{};
+    };
     
-    inline JsonInitValue::JsonInitValue(std::string KeyIn, const TJsonInitList& List) :
-    Key(std::move(KeyIn))
+    struct JsonSerializeOptions
     {
-        Value = InitFromList(List, false);
-    }
+        bool bPretty{false};
 
-    inline JsonInitValue::JsonInitValue(TJsonInitList&& List)
+        // Digits after the decimal point for doubles, negative for the shortest round-trip representation
+        int FloatPrecision{-1};
+
+        // Bytes collected before a streaming Serialize hands them to its sink
+        size_t StreamBufferSize{64 * 1024};
+    };
+
+    // Destination of streamed output, receives the text in pieces and returns false once it cannot take more
+    template<typename T>
+    concept CJsonSink = requires(T& Sink, std::string_view Data)
     {
-        Value = InitFromList(List, false);
-    }
-    
-    inline JsonInitValue::JsonInitValue(std::string KeyIn, InitValue ValueIn) :
-    Key(std::move(KeyIn)),
-    Value(std::move(ValueIn.Value))
+        { Sink.Write(Data) } -> std::convertible_to<bool>;
+    };
+
+    // Writes to a file descriptor, the descriptor stays owned by the caller
+    struct JsonFileDescriptorSink
     {
-    }
-    
-    inline JsonInitValue::JsonInitValue(InitValue ValueIn) :
-    Value(std::move(ValueIn.Value))
+        bool Write(std::string_view Data)
+        {
+            while(!Data.empty())
+            {
+#if defined(_WIN32)
+                const int Written = _write(FileDescriptor, Data.data(), static_cast<unsigned int>(std::min<size_t>(Data.size(), std::numeric_limits<int>::max())));
+#else
+                const ssize_t Written = ::write(FileDescriptor, Data.data(), Data.size());
+                if(Written < 0 && errno == EINTR) continue;
+#endif
+                if(Written <= 0) return false;
+                Data.remove_prefix(static_cast<size_t>(Written));
+            }
+            return true;
+        }
+
+        int FileDescriptor{-1};
+    };
+
+    struct JsonOStreamSink
     {
-    }
+        bool Write(std::string_view Data)
+        {
+            Stream.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+            return static_cast<bool>(Stream);
+        }
 
-    inline JsonValue JsonInitValue::InitFromList(const TJsonInitList& List, bool bObjectOnly)
+        std::ostream& Stream;
+    };
+
+    // Hands every piece to a callable taking a std::string_view and returning whether to continue
+    template<typename TCallback>
+    struct JsonCallbackSink
     {
-        if(List.size() < 1) return {};
+        bool Write(std::string_view Data)
+        {
+            return Callback(Data);
+        }
 
-        const bool bIsObject = List.begin()->Key.has_value();
-        JsonValue Value;
-        if(bIsObject)
+        TCallback Callback;
+    };
+
+    template<typename TCallback>
+    JsonCallbackSink(TCallback) -> JsonCallbackSink<TCallback>;
+
+    // Fixed-size buffer in front of a sink. Writers append to GetBuffer and call Commit at value boundaries,
+    // the buffer is flushed once it holds Capacity bytes so memory use stays constant whatever the output size.
+    template<CJsonSink TSink>
+    class JsonBufferedOutput
+    {
+    public:
+        explicit JsonBufferedOutput(TSink& SinkIn, size_t CapacityIn = 64 * 1024) :
+        Sink(SinkIn),
+        Capacity(std::max<size_t>(CapacityIn, 1))
         {
-            auto Obj = std::make_shared<JsonObject>();
-            for(const auto& InitValue : List)
+            // Headroom for the value that crosses the threshold
+            Buffer.reserve(Capacity + Capacity / 4);
+        }
+
+        JsonBufferedOutput(const JsonBufferedOutput& Other) = delete;
+        JsonBufferedOutput& operator=(const JsonBufferedOutput& Other) = delete;
+
+        ~JsonBufferedOutput()
+        {
+            Flush();
+        }
+
+        [[nodiscard]] std::string& GetBuffer()
+        {
+            return Buffer;
+        }
+
+        void Commit()
+        {
+            if(Buffer.size() >= Capacity)
             {
-                if(!InitValue.Key.has_value()) continue;
-                Obj->Properties.emplace(*InitValue.Key, InitValue.Value);
+                Flush();
             }
-
-            Value = std::move(Obj);
         }
-        else if(!bObjectOnly)
+
+        bool Flush()
         {
-            auto Array = std::make_shared<JsonArray>(); 
-            for(const auto& InitValue : List)
+            if(!Buffer.empty() && !bFailed)
             {
-                if(InitValue.Key.has_value()) continue;
-                Array->Values.push_back(InitValue.Value);
+                bFailed = !Sink.Write(Buffer);
             }
+            
+            Buffer.clear();
+            return !bFailed;
+        }
 
-            Value = std::move(Array);
+        // The sink refused data, everything written afterwards is dropped
+        [[nodiscard]] bool HasError() const
+        {
+            return bFailed;
         }
 
-        return std::move(Value);
-    }
+    private:
+        TSink& Sink;
+        std::string Buffer{};
+        size_t Capacity{};
+        bool bFailed{};
+    };
 
-    
-    inline JsonValueWrapper<JsonValue> JsonObject::operator[](const std::string& Key)
+    namespace Detail
     {
-        auto& Value = Properties[Key];
-        return {Value};
-    }
+        // Serializer output appending to a caller owned string, never flushed
+        struct StringOutput
+        {
+            [[nodiscard]] std::string& GetBuffer()
+            {
+                return Buffer;
+            }
 
-    inline JsonValueWrapper<const JsonValue> JsonObject::operator[](const std::string& Key) const
+            void Commit()
+            {
+            }
+
+            [[nodiscard]] bool HasError() const
+            {
+                return false;
+            }
+
+            std::string& Buffer;
+        };
+    }
+    
+    class Json
     {
-        if(auto It = Properties.find(Key); It != Properties.end())
+    public:
+        Json()
         {
-            return {It->second};
+            Root = std::make_shared<JsonObject>();
         }
-        
-        static JsonValue EmptyValue = UndefinedValue{};
-        return {EmptyValue};
-    }
 
-    inline JsonValueWrapper<JsonValue> JsonArray::operator[](size_t Index)
-    {
-        auto& Value = Values.at(Index);
-        return {Value};
-    }
+        // The tokenizer state is not copied, it refers to the input and structural index of Other
+        Json(const Json& Other) :
+        ErrorMessage{Other.ErrorMessage},
+        Root{CopyRoot(Other.Root)}
+        {
+            Tokenizer.Init("");
+        }
 
-    inline JsonValueWrapper<const JsonValue> JsonArray::operator[](size_t Index) const
-    {
-        const auto& Value = Values.at(Index);
-        return {Value};
-    }
+        Json(Json&& Other) :
+        Tokenizer{std::move(Other.Tokenizer)},
+        CurrentToken{Other.CurrentToken},
+        ErrorMessage{std::move(Other.ErrorMessage)},
+        Root{std::move(Other.Root)},
+        Arena{std::move(Other.Arena)},
+        MappedFile{std::move(Other.MappedFile)}
+        {
+            Other.Tokenizer.Init("");
+            Other.CurrentToken = {JsonTokenType::NotSet, 0, ""};
+            Other.ErrorMessage.reset();
+            Other.Root = UndefinedValue{};
+        }
 
-    inline JsonValueWrapper<JsonValue> JsonArray::AddValue()
-    {
-        Values.emplace_back();
-        auto& Value = Values.back();
-        
-        return {Value};
-    }
+        Json& operator=(const Json& Other)
+        {
+            if(this != &Other)
+            {
+                Tokenizer.Init("");
+                CurrentToken = {JsonTokenType::NotSet, 0, ""};
+                ErrorMessage = Other.ErrorMessage;
+                Root = CopyRoot(Other.Root);
+            }
+            return *this;
+        }
+
+        Json& operator=(Json&& Other)
+        {
+            if(this != &Other)
+            {
+                Tokenizer = std::move(Other.Tokenizer);
+                CurrentToken = Other.CurrentToken;
+                ErrorMessage = std::move(Other.ErrorMessage);
+                Root = std::move(Other.Root);
+                Arena = std::move(Other.Arena);
+                MappedFile = std::move(Other.MappedFile);
+
+                Other.Tokenizer.Init("");
+                Other.CurrentToken = {JsonTokenType::NotSet, 0, ""};
+                Other.ErrorMessage.reset();
+                Other.Root = UndefinedValue{};
+            }
+            return *this;
+        }
+
+        Json(const TJsonInitList& List)
+        {
+            InitFromList(List);
+        }
+
+        Json& operator=(const TJsonInitList& List)
+        {
+            InitFromList(List);
+            return *this;
+        }
+
+        // An undefined or null root is turned into an object
+        JsonValueWrapper<JsonValue> operator[](const std::string& Key)
+        {
+            if(HasType<UndefinedValue>(Root) || HasType<nullptr_t>(Root))
+            {
+                Root = std::make_shared<JsonObject>();
+            }
+
+            const auto& Object = GetRootObject();
+            if(!Object) throw std::runtime_error("Root is not an object");
+
+            auto& Value = Object->Properties[Key];
+            return {Value};
+        }
+
+        JsonValueWrapper<const JsonValue> operator[](const std::string& Key) const
+        {
+            const auto& Object = GetRootObject();
+            if(!Object) throw std::runtime_error("Root object is null, const access not possible");
+            
+            auto& Value = Object->Properties[Key];
+            return {Value};
+        }
+
+        // Element of an array root, throws if the root is not an array or the index is out of range
+        JsonValueWrapper<JsonValue> operator[](size_t Index)
+        {
+            const auto& Array = GetRootArray();
+            if(!Array) throw std::runtime_error("Root is not an array");
+            
+            return (*Array)[Index];
+        }
+
+        JsonValueWrapper<const JsonValue> operator[](size_t Index) const
+        {
+            const auto& Array = GetRootArray();
+            if(!Array) throw std::runtime_error("Root is not an array");
+            
+            return std::as_const(*Array)[Index];
+        }
+
+        void Reset(bool bCreateRoot = true)
+        {
+            if(bCreateRoot)
+            {
+                if(const auto& Object = GetRootObject())
+                {
+                    Object->Properties.clear();
+                }
+                else
+                {
+                    Root = std::make_shared<JsonObject>();
+                }
+            }
+            else
+            {
+                Root = UndefinedValue{};
+            }
+            
+            Tokenizer.Init("");
+            StructuralIndex.Clear();
+            ErrorMessage.reset();
+            CurrentToken = {JsonTokenType::NotSet, 0, ""};
+            MappedFile.reset();
+        }
+
+        void Parse(std::string_view Input, const JsonParseOptions& Options = {})
+        {
+            const bool bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+            Tokenizer.Init(Input, bIndexed ? &StructuralIndex : nullptr);
+            ErrorMessage.reset();
+
+            // Release the previous document first so its arena can be reused
+            Root = UndefinedValue{};
+            MaxDepth = Options.MaxDepth;
+            MappedFile.reset();
+            bParseInArena = Options.bUseArena || Options.SharedArena;
+            if(Options.SharedArena)
+            {
+                Arena = Options.SharedArena;
+            }
+            else if(bParseInArena)
+            {
+                PrepareArena();
+            }
+            
+            Root = ParseValue();
+            if(!HasError())
+            {
+                Consume();
+                if(CurrentToken.Type != JsonTokenType::None)
+                {
+                    ThrowError(CurrentToken, "Unexpected data after the root value");
+                }
+            }
+
+            if(HasError())
+            {
+                Root = UndefinedValue{};
+            }
+        }
+
+        // Parses a file through a read-only memory mapping instead of reading it into a buffer first.
+        // With bKeepMapping the mapping stays open until the next parse so views into the raw file remain valid.
+        void ParseFile(const std::string& Path, const JsonParseOptions& Options = {}, bool bKeepMapping = false)
+        {
+            auto File = std::make_shared<JsonMappedFile>();
+            if(!File->Open(Path))
+            {
+                Reset(false);
+                ErrorMessage = std::string(File->GetError());
+                return;
+            }
+
+            Parse(File->GetData(), Options);
+            if(bKeepMapping)
+            {
+                MappedFile = std::move(File);
+            }
+        }
+
+        // Mapping kept by ParseFile, null if none
+        [[nodiscard]] const std::shared_ptr<JsonMappedFile>& GetMappedFile() const
+        {
+            return MappedFile;
+        }
+
+        [[nodiscard]] std::string Serialize(bool bPretty) const
+        {
+            JsonSerializeOptions Options{};
+            Options.bPretty = bPretty;
+            
+            return Serialize(Options);
+        }
+
+        [[nodiscard]] std::string Serialize(const JsonSerializeOptions& Options) const
+        {
+            std::string Result;
+            Serialize(Result, Options);
+            
+            return Result;
+        }
+
+        // Replaces the content of Out, keeping its capacity so the buffer can be reused across calls
+        void Serialize(std::string& Out, const JsonSerializeOptions& Options = {}) const
+        {
+            Out.clear();
+            
+            Detail::StringOutput Output{Out};
+            SerializeRoot(Output, Options);
+        }
+
+        // Streams the document into Sink through a buffer of Options.StreamBufferSize bytes instead of building one string.
+        // Returns false if the sink stopped accepting data.
+        template<CJsonSink TSink>
+        bool Serialize(TSink& Sink, const JsonSerializeOptions& Options = {}) const
+        {
+            JsonBufferedOutput<TSink> Output{Sink, Options.StreamBufferSize};
+            SerializeRoot(Output, Options);
+            
+            return Output.Flush();
+        }
+        
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            if(ErrorMessage.has_value())
+            {
+                return *ErrorMessage;
+            }
+            return "";
+        }
+
+        // The root can hold any value, it is undefined after a failed parse
+        [[nodiscard]] JsonValue& GetRoot()
+        {
+            return Root;
+        }
+
+        [[nodiscard]] const JsonValue& GetRoot() const
+        {
+            return Root;
+        }
+
+        // Null when the root is not an object
+        [[nodiscard]] const std::shared_ptr<JsonObject>& GetRootObject() const
+        {
+            return GetRootAs<JsonObject>();
+        }
+
+        // Null when the root is not an array
+        [[nodiscard]] const std::shared_ptr<JsonArray>& GetRootArray() const
+        {
+            return GetRootAs<JsonArray>();
+        }
+
+    private:
+        void InitFromList(const TJsonInitList& List)
+        {
+            if(!GetRootObject())
+            {
+                Root = std::make_shared<JsonObject>();
+            }
+
+            *GetRootObject() = List;
+        }
+
+        template<typename T>
+        const std::shared_ptr<T>& GetRootAs() const
+        {
+            static const std::shared_ptr<T> Null{};
+            
+            const auto* Container = std::get_if<std::shared_ptr<T>>(&Root);
+            return Container ? *Container : Null;
+        }
+
+        // Copies get their own root container, nested containers are shared like in JsonObject copies
+        static JsonValue CopyRoot(const JsonValue& Value)
+        {
+            if(const auto* Object = std::get_if<std::shared_ptr<JsonObject>>(&Value); Object && *Object)
+            {
+                auto Copy = std::make_shared<JsonObject>();
+                *Copy = **Object;
+                return Copy;
+            }
+            if(const auto* Array = std::get_if<std::shared_ptr<JsonArray>>(&Value); Array && *Array)
+            {
+                auto Copy = std::make_shared<JsonArray>();
+                *Copy = **Array;
+                return Copy;
+            }
+            return Value;
+        }
+        
+        void PrepareArena()
+        {
+            if(Arena && Arena.use_count() == 1)
+            {
+                Arena->Reset();
+            }
+            else
+            {
+                Arena = std::make_shared<JsonArena>();
+            }
+        }
+
+        std::shared_ptr<JsonObject> MakeObject() const
+        {
+            if(bParseInArena)
+            {
+                return std::allocate_shared<JsonObject>(JsonArenaAllocator<JsonObject>{Arena}, Arena.get());
+            }
+            return std::make_shared<JsonObject>();
+        }
+
+        std::shared_ptr<JsonArray> MakeArray() const
+        {
+            if(bParseInArena)
+            {
+                return std::allocate_shared<JsonArray>(JsonArenaAllocator<JsonArray>{Arena}, Arena.get());
+            }
+            return std::make_shared<JsonArray>();
+        }
+        
+        void Peek()
+        {
+            UpdateToken(true);
+        }
+
+        void Consume()
+        {
+            UpdateToken(false);
+        }
+
+        void UpdateToken(bool bPeak)
+        {
+            CurrentToken = bPeak ? Tokenizer.PeekToken() : Tokenizer.GetToken();
+            if(CurrentToken.Type == JsonTokenType::Error)
+            {
+                ThrowError(CurrentToken, CurrentToken.Value);
+            }
+        }
+
+        //Serialization
+        template<typename TOutput>
+        void SerializeRoot(TOutput& Output, const JsonSerializeOptions& Options) const;
+        template<typename TOutput>
+        void SerializeValue(const JsonValue& Value, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const;
+        template<typename TOutput>
+        void SerializeArray(const JsonArray& Array, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const;
+        template<typename TOutput>
+        void SerializeObject(const JsonObject& Object, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const;
+
+        //Deserialization
+        friend class JsonParallelArrayParser;
+        friend class JsonParallelLinesParser;
+        
+        // Parses the consecutive array elements starting at Offset into Slots, for the parallel array parser
+        bool ParseArrayElements(std::string_view Input, const JsonStructuralIndex& Index, size_t Offset, std::span<JsonValue> Slots, const JsonParseOptions& Options);
+        
+        JsonValue ParseValue();
+        
+        // Reads "key": and returns the slot of its value, nullptr on error
+        JsonValue* ParseKey(JsonObject& Object);
+        
+        void ThrowError(const JsonToken& Token, std::string_view message);
+    
+    
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        JsonToken CurrentToken{};
+        std::optional<std::string> ErrorMessage{}; 
+        JsonValue Root;
+        
+        std::shared_ptr<JsonArena> Arena;
+        bool bParseInArena{};
+
+        std::shared_ptr<JsonMappedFile> MappedFile;
+
+        // Open containers of the value being parsed, exactly one of the pointers is set
+        struct ParseFrame
+        {
+            JsonObject* Object{};
+            JsonArray* Array{};
+        };
+        
+        std::vector<ParseFrame> ParseStack{};
+        std::deque<JsonValue> DiscardedValues{};
+        size_t MaxDepth{};
+    };
+
+    template<typename TOutput>
+    void Json::SerializeRoot(TOutput& Output, const JsonSerializeOptions& Options) const
+    {
+        if(const auto& Object = GetRootObject())
+        {
+            SerializeObject(*Object, Output, Options, 0);
+        }
+        else if(const auto& Array = GetRootArray())
+        {
+            SerializeArray(*Array, Output, Options, 0);
+        }
+        else if(!HasType<UndefinedValue>(Root))
+        {
+            SerializeValue(Root, Output, Options, 0);
+        }
+    }
+    
+    template<typename TOutput>
+    void Json::SerializeValue(const JsonValue& Value, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const
+    {
+        std::string& Result = Output.GetBuffer();
+        if(HasType<int64_t>(Value))
+        {
+            Detail::AppendInteger(Result, std::get<int64_t>(Value));
+        }
+        else if(HasType<double>(Value))
+        {
+            Detail::AppendDouble(Result, std::get<double>(Value), Options.FloatPrecision);
+        }
+        else if(HasType<nullptr_t>(Value))
+        {
+           Result += "null";
+        }
+        else if(HasType<bool>(Value))
+        {
+            Result += std::get<bool>(Value) ? "true" : "false";
+        }
+        else if(HasType<std::string>(Value))
+        {
+            Detail::AppendEscapedString(Result, std::get<std::string>(Value));
+        }
+        else if(HasType<JsonArray>(Value))
+        {
+            SerializeArray(*std::get<std::shared_ptr<JsonArray>>(Value), Output, Options, Depth + 1);
+        }
+        else if(HasType<JsonObject>(Value))
+        {
+            SerializeObject(*std::get<std::shared_ptr<JsonObject>>(Value), Output, Options, Depth + 1);
+        }
+    }
+
+    template<typename TOutput>
+    void Json::SerializeArray(const JsonArray& Array, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const
+    {
+        std::string& Result = Output.GetBuffer();
+        Result += '[';
+
+        size_t Written{};
+        for(const auto& Value : Array.Values)
+        {
+            if(HasType<UndefinedValue>(Value)) continue;
+            
+            if(Written > 0)
+            {
+                Result += ',';
+            }
+
+            if(Options.bPretty)
+            {
+                Result += '\n';
+                Result.append(Depth + 1, '\t');
+            }
+
+            SerializeValue(Value, Output, Options, Depth);
+            ++Written;
+
+            Output.Commit();
+            if(Output.HasError()) return;
+        }
+
+        if(Options.bPretty && Written > 0)
+        {
+            Result += '\n';
+            Result.append(Depth, '\t');
+        }
+        
+        Result += ']';
+    }
+
+    template<typename TOutput>
+    void Json::SerializeObject(const JsonObject& Object, TOutput& Output, const JsonSerializeOptions& Options, size_t Depth) const
+    {
+        std::string& Result = Output.GetBuffer();
+        Result += '{';
+
+        size_t Written{};
+        for(const auto& [Key, Value] : Object.Properties)
+        {
+            // Fields created by a lookup but never assigned
+            if(HasType<UndefinedValue>(Value)) continue;
+            
+            if(Written > 0)
+            {
+                Result += ',';
+            }
+
+            if(Options.bPretty)
+            {
+                Result += '\n';
+                Result.append(Depth + 1, '\t');
+            }
+
+            Detail::AppendEscapedString(Result, Key);
+            Result += ':';
+            
+            if(Options.bPretty && (HasType<JsonObject>(Value) || HasType<JsonArray>(Value)))
+            {
+                Result += '\n';
+                Result.append(Depth + 1, '\t');
+            }
+            else
+            {
+                Result += ' ';
+            }
+
+            SerializeValue(Value, Output, Options, Depth);
+            ++Written;
+
+            Output.Commit();
+            if(Output.HasError()) return;
+        }
+
+        if(Options.bPretty && Written > 0)
+        {
+            Result += '\n';
+            Result.append(Depth, '\t');
+        }
+
+        Result += '}';
+    }
+
+    // Iterative so the nesting depth is only bounded by MaxDepth, not by the call stack.
+    // Containers are created on their opening token and the frame stack tracks where the next value goes.
+    inline JsonValue Json::ParseValue()
+    {
+        JsonValue Result;
+        JsonValue* Target = &Result;
+        
+        ParseStack.clear();
+        DiscardedValues.clear();
+        
+        for(;;)
+        {
+            Consume();
+            switch(CurrentToken.Type)
+            {
+                case JsonTokenType::ObjectStart:
+                case JsonTokenType::ArrayStart:
+                {
+                    if(ParseStack.size() >= MaxDepth)
+                    {
+                        ThrowParserError(CurrentToken, "Maximum nesting depth exceeded");
+                    }
+                    
+                    ParseFrame Frame{};
+                    if(CurrentToken.Type == JsonTokenType::ObjectStart)
+                    {
+                        auto Object = MakeObject();
+                        Frame.Object = Object.get();
+                        *Target = std::move(Object);
+                    }
+                    else
+                    {
+                        auto Array = MakeArray();
+                        Frame.Array = Array.get();
+                        *Target = std::move(Array);
+                    }
+
+                    Peek();
+                    if(CurrentToken.Type == (Frame.Object ? JsonTokenType::ObjectEnd : JsonTokenType::ArrayEnd))
+                    {
+                        Consume();
+                        break;
+                    }
+
+                    ParseStack.push_back(Frame);
+                    Target = Frame.Object ? ParseKey(*Frame.Object) : &Frame.Array->Values.emplace_back();
+                    if(!Target) return {};
+                    continue;
+                }
+                case JsonTokenType::String:
+                {
+                    *Target = JsonTokenizer::DecodeString(CurrentToken);
+                    break;
+                }
+                case JsonTokenType::Number:
+                {
+                    if(CurrentToken.bIsFloat)
+                    {
+                        *Target = CurrentToken.Number.Float;
+                    }
+                    else
+                    {
+                        *Target = CurrentToken.Number.Integer;
+                    }
+                    break;
+                }
+                case JsonTokenType::Null:
+                {
+                    *Target = nullptr;
+                    break;
+                }
+                case JsonTokenType::Boolean:
+                {
+                    *Target = CurrentToken.Value == "true";
+                    break;
+                }
+                default:
+                {
+                    ThrowParserError(CurrentToken, std::format("Unexpected token while parsing value: {}", CurrentToken.Value));
+                }
+            }
+
+            // The value is complete, close finished containers until the next value slot
+            for(Target = nullptr; !Target; )
+            {
+                if(ParseStack.empty()) return Result;
+                
+                const ParseFrame& Frame = ParseStack.back();
+                Consume();
+                
+                if(CurrentToken.Type == JsonTokenType::Comma)
+                {
+                    Target = Frame.Object ? ParseKey(*Frame.Object) : &Frame.Array->Values.emplace_back();
+                    if(!Target) return {};
+                }
+                else if(CurrentToken.Type == (Frame.Object ? JsonTokenType::ObjectEnd : JsonTokenType::ArrayEnd))
+                {
+                    ParseStack.pop_back();
+                }
+                else
+                {
+                    ThrowParserError(CurrentToken, Frame.Object ? "Expected ',' or '}'" : "Expected ',' or ']'");
+                }
+            }
+        }
+    }
+
+    inline JsonValue* Json::ParseKey(JsonObject& Object)
+    {
+        Consume();
+        if(CurrentToken.Type != JsonTokenType::String)
+        {
+            ThrowError(CurrentToken, "Expected string key");
+            return nullptr;
+        }
+        auto Key = JsonTokenizer::DecodeString(CurrentToken);
+
+        Consume();
+        if(CurrentToken.Type != JsonTokenType::Colon)
+        {
+            ThrowError(CurrentToken, "Expected ':'");
+            return nullptr;
+        }
+
+        // The first occurrence of a duplicate key is kept, later ones are parsed into storage that outlives their frames
+        auto [It, bInserted] = Object.Properties.try_emplace(std::move(Key));
+        return bInserted ? &It->second : &DiscardedValues.emplace_back();
+    }
+
+    inline bool Json::ParseArrayElements(std::string_view Input, const JsonStructuralIndex& Index, size_t Offset, std::span<JsonValue> Slots, const JsonParseOptions& Options)
+    {
+        Tokenizer.Init(Input, &Index);
+        Tokenizer.Seek(Offset);
+        ErrorMessage.reset();
+        
+        bParseInArena = Options.SharedArena != nullptr;
+        Arena = Options.SharedArena;
+        
+        // The elements sit one level below the root array
+        MaxDepth = Options.MaxDepth > 0 ? Options.MaxDepth - 1 : 0;
+
+        for(JsonValue& Slot : Slots)
+        {
+            Slot = ParseValue();
+            if(HasError()) return false;
+
+            // Element boundaries come from the structural pre-scan, the separators still have to be valid
+            Consume();
+            if(CurrentToken.Type != JsonTokenType::Comma && CurrentToken.Type != JsonTokenType::ArrayEnd)
+            {
+                ThrowError(CurrentToken, "Expected ',' or ']'");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void Json::ThrowError(const JsonToken& Token, std::string_view message)
+    {
+        if(HasError()) return;
+        ErrorMessage = Tokenizer.FormatError(Token, message);
+    }
+    
+
+    template<typename T>
+    bool HasType(const JsonValue& Value)
+    {
+        using TType = typename TJsonValueTypeConverter<T>::Type;
+        return std::holds_alternative<TType>(Value);
+    }
+    
+    template<typename T>
+    bool HasField(JsonObject& JsonObject, const std::string& Key)
+    {
+        const auto It = JsonObject.Properties.find(Key);
+        if(It != JsonObject.Properties.end())
+        {
+            if constexpr(std::is_same_v<T, void>)
+            {
+                return true;
+            }
+            else
+            {
+                return HasType<T>(It->second);
+            }
+        }
+
+        return false;
+    }
+
+    template<typename T>
+    bool HasField(const JsonArray& JsonArray, size_t Index)
+    {
+        if(Index >= JsonArray.Values.size()) return false;
+        if constexpr(std::is_same_v<T, void>)
+        {
+            return true;
+        }
+        else
+        {
+            return HasType<T>(JsonArray.Values[Index]);
+        }
+    }
+
+    template<typename T>
+    bool HasField(const Json& JsonParser, const std::string& Key)
+    {
+        if(!JsonParser.GetRootObject()) return false;
+        return HasField<T>(*JsonParser.GetRootObject(), Key);
+    }
+    
+    
+    inline JsonInitValue::JsonInitValue(std::string KeyIn, const TJsonInitList& List) :
+    Key(std::move(KeyIn))
+    {
+        Value = InitFromList(List, false);
+    }
+
+    inline JsonInitValue::JsonInitValue(TJsonInitList&& List)
+    {
+        Value = InitFromList(List, false);
+    }
+    
+    inline JsonInitValue::JsonInitValue(std::string KeyIn, InitValue ValueIn) :
+    Key(std::move(KeyIn)),
+    Value(std::move(ValueIn.Value))
+    {
+    }
+    
+    inline JsonInitValue::JsonInitValue(InitValue ValueIn) :
+    Value(std::move(ValueIn.Value))
+    {
+    }
+
+    inline JsonValue JsonInitValue::InitFromList(const TJsonInitList& List, bool bObjectOnly)
+    {
+        if(List.size() < 1) return {};
+
+        const bool bIsObject = List.begin()->Key.has_value();
+        JsonValue Value;
+        if(bIsObject)
+        {
+            auto Obj = std::make_shared<JsonObject>();
+            for(const auto& InitValue : List)
+            {
+                if(!InitValue.Key.has_value()) continue;
+                Obj->Properties.emplace(*InitValue.Key, InitValue.Value);
+            }
+
+            Value = std::move(Obj);
+        }
+        else if(!bObjectOnly)
+        {
+            auto Array = std::make_shared<JsonArray>(); 
+            for(const auto& InitValue : List)
+            {
+                if(InitValue.Key.has_value()) continue;
+                Array->Values.push_back(InitValue.Value);
+            }
+
+            Value = std::move(Array);
+        }
+
+        return std::move(Value);
+    }
+
+    
+    inline JsonValueWrapper<JsonValue> JsonObject::operator[](const std::string& Key)
+    {
+        auto& Value = Properties[Key];
+        return {Value};
+    }
+
+    inline JsonValueWrapper<const JsonValue> JsonObject::operator[](const std::string& Key) const
+    {
+        if(auto It = Properties.find(Key); It != Properties.end())
+        {
+            return {It->second};
+        }
+        
+        static JsonValue EmptyValue = UndefinedValue{};
+        return {EmptyValue};
+    }
+
+    inline JsonValueWrapper<JsonValue> JsonArray::operator[](size_t Index)
+    {
+        auto& Value = Values.at(Index);
+        return {Value};
+    }
+
+    inline JsonValueWrapper<const JsonValue> JsonArray::operator[](size_t Index) const
+    {
+        const auto& Value = Values.at(Index);
+        return {Value};
+    }
+
+    inline JsonValueWrapper<JsonValue> JsonArray::AddValue()
+    {
+        Values.emplace_back();
+        auto& Value = Values.back();
+        
+        return {Value};
+    }
+
+    // Type of a value in the read-only document representations
+    enum class JsonValueType : uint8_t
+    {
+        Undefined,
+        Null,
+        Boolean,
+        Integer,
+        Double,
+        String,
+        Array,
+        Object
+    };
+
+    namespace Detail
+    {
+        // Same type mapping as HasType, integral types map to Integer and floating point types to Double
+        template<typename T>
+        constexpr bool IsValueTypeOf(JsonValueType ValueType)
+        {
+            if constexpr(std::is_same_v<T, bool>) return ValueType == JsonValueType::Boolean;
+            else if constexpr(std::is_integral_v<T>) return ValueType == JsonValueType::Integer;
+            else if constexpr(std::is_floating_point_v<T>) return ValueType == JsonValueType::Double;
+            else if constexpr(std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) return ValueType == JsonValueType::String;
+            else if constexpr(std::is_same_v<T, std::nullptr_t>) return ValueType == JsonValueType::Null;
+            else if constexpr(std::is_same_v<T, UndefinedValue>) return ValueType == JsonValueType::Undefined;
+            else if constexpr(std::is_same_v<T, JsonArray>) return ValueType == JsonValueType::Array;
+            else if constexpr(std::is_same_v<T, JsonObject>) return ValueType == JsonValueType::Object;
+            else static_assert(sizeof(T) == 0, "Unsupported type");
+        }
+    }
+
+    // 16-byte read-only value of a JsonCompactDocument. Strings of up to 14 characters are stored inline,
+    // longer strings and container elements live in the document's arena and are referenced by raw pointers.
+    class JsonCompactValue
+    {
+    public:
+        using Type = JsonValueType;
+
+        static constexpr size_t MaxInlineSize = 14;
+        
+        JsonCompactValue() = default;
+
+        [[nodiscard]] Type GetType() const
+        {
+            return ValueType;
+        }
+
+        [[nodiscard]] bool IsUndefined() const { return ValueType == Type::Undefined; }
+        [[nodiscard]] bool IsNull() const { return ValueType == Type::Null; }
+        [[nodiscard]] bool IsArray() const { return ValueType == Type::Array; }
+        [[nodiscard]] bool IsObject() const { return ValueType == Type::Object; }
+
+        template<typename T>
+        [[nodiscard]] bool HasType() const
+        {
+            return Detail::IsValueTypeOf<T>(ValueType);
+        }
+
+        template<typename T>
+        [[nodiscard]] T GetAs() const
+        {
+            if(!HasType<T>())
+            {
+                throw std::runtime_error("Field is not of the requested type");
+            }
+
+            if constexpr(std::is_same_v<T, bool>) return Load<bool>(0);
+            else if constexpr(std::is_integral_v<T>) return static_cast<T>(Load<int64_t>(0));
+            else if constexpr(std::is_floating_point_v<T>) return static_cast<T>(Load<double>(0));
+            else return T{GetString()};
+        }
+
+        // Returns Default if the value is missing or of another type
+        template<typename T>
+        [[nodiscard]] T Or(T Default) const
+        {
+            return HasType<T>() ? GetAs<T>() : Default;
+        }
+
+        [[nodiscard]] std::string_view Or(const char* Default) const
+        {
+            return Or<std::string_view>(Default);
+        }
+
+        template<typename T>
+        requires(std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+        operator T() const
+        {
+            return GetAs<T>();
+        }
+
+        // Number of elements of an array or properties of an object
+        [[nodiscard]] size_t GetSize() const
+        {
+            return IsArray() || IsObject() ? Load<uint32_t>(8) : 0;
+        }
+
+        // Undefined value if the index is out of range or this is not an array
+        const JsonCompactValue& operator[](size_t Index) const
+        {
+            if(!IsArray() || Index >= GetSize()) return GetUndefined();
+            return GetChildren()[Index];
+        }
+
+        // Undefined value if the key does not exist or this is not an object
+        const JsonCompactValue& operator[](std::string_view Key) const
+        {
+            if(!IsObject()) return GetUndefined();
+
+            const JsonCompactValue* Children = GetChildren();
+            for(size_t Index = 0, Size = GetSize(); Index < Size; ++Index)
+            {
+                if(Children[Index * 2].GetString() == Key)
+                {
+                    return Children[Index * 2 + 1];
+                }
+            }
+            
+            return GetUndefined();
+        }
+
+        const JsonCompactValue& operator[](const char* Key) const
+        {
+            return (*this)[std::string_view{Key}];
+        }
+
+        // Object properties in document order
+        [[nodiscard]] std::string_view GetKeyAt(size_t Index) const
+        {
+            return GetChildren()[Index * 2].GetString();
+        }
+
+        [[nodiscard]] const JsonCompactValue& GetValueAt(size_t Index) const
+        {
+            return GetChildren()[IsObject() ? Index * 2 + 1 : Index];
+        }
+
+    private:
+        friend class JsonCompactDocument;
+
+        template<typename T>
+        [[nodiscard]] T Load(size_t Offset) const
+        {
+            T Result;
+            std::memcpy(&Result, Storage + Offset, sizeof(T));
+            return Result;
+        }
+
+        template<typename T>
+        void Store(size_t Offset, T Value)
+        {
+            std::memcpy(Storage + Offset, &Value, sizeof(T));
+        }
+        
+        [[nodiscard]] std::string_view GetString() const
+        {
+            if(InlineSize <= MaxInlineSize) return {Storage, InlineSize};
+            return {Load<const char*>(0), Load<uint32_t>(8)};
+        }
+
+        [[nodiscard]] const JsonCompactValue* GetChildren() const
+        {
+            return Load<const JsonCompactValue*>(0);
+        }
+
+        static const JsonCompactValue& GetUndefined()
+        {
+            static const JsonCompactValue Undefined{};
+            return Undefined;
+        }
+
+        template<typename T>
+        static JsonCompactValue Make(Type ValueType, T Value)
+        {
+            JsonCompactValue Result;
+            Result.ValueType = ValueType;
+            Result.Store(0, Value);
+            return Result;
+        }
+        
+        // Large strings must already be copied into the arena
+        static JsonCompactValue MakeString(std::string_view String)
+        {
+            JsonCompactValue Result;
+            Result.ValueType = Type::String;
+            if(String.size() <= MaxInlineSize)
+            {
+                std::memcpy(Result.Storage, String.data(), String.size());
+                Result.InlineSize = static_cast<uint8_t>(String.size());
+            }
+            else
+            {
+                Result.InlineSize = MaxInlineSize + 1;
+                Result.Store(0, String.data());
+                Result.Store(8, static_cast<uint32_t>(String.size()));
+            }
+            return Result;
+        }
+
+        static JsonCompactValue MakeContainer(Type ValueType, const JsonCompactValue* Children, size_t Size)
+        {
+            JsonCompactValue Result = Make(ValueType, Children);
+            Result.Store(8, static_cast<uint32_t>(Size));
+            return Result;
+        }
+
+        alignas(8) char Storage[MaxInlineSize]{};
+        uint8_t InlineSize{};
+        Type ValueType{Type::Undefined};
+    };
+
+    static_assert(sizeof(JsonCompactValue) == 16);
+
+    // Read-only document storing its values as JsonCompactValue in an arena, about a quarter of the memory of a Json tree.
+    // Object properties keep their document order and are looked up linearly.
+    class JsonCompactDocument
+    {
+    public:
+        JsonCompactDocument() :
+        Arena(std::make_unique<JsonArena>())
+        {
+            
+        }
+        
+        // A moved-from document is empty, its arena is recreated by the next Parse
+        JsonCompactDocument(JsonCompactDocument&& Other) noexcept :
+        Arena(std::move(Other.Arena)),
+        Root(std::exchange(Other.Root, {})),
+        ErrorMessage(std::move(Other.ErrorMessage))
+        {
+            Other.ErrorMessage.reset();
+        }
+        
+        JsonCompactDocument& operator=(JsonCompactDocument&& Other) noexcept
+        {
+            if(this != &Other)
+            {
+                Arena = std::move(Other.Arena);
+                Root = std::exchange(Other.Root, {});
+                ErrorMessage = std::move(Other.ErrorMessage);
+                Other.ErrorMessage.reset();
+            }
+            return *this;
+        }
+
+        // The input may be released after parsing, all strings are copied into the document
+        void Parse(std::string_view Input, const JsonParseOptions& Options = {})
+        {
+            if(Arena)
+            {
+                Arena->Reset();
+            }
+            else
+            {
+                Arena = std::make_unique<JsonArena>();
+            }
+            Root = {};
+            ErrorMessage.reset();
+            Depth = 0;
+            MaxDepth = Options.MaxDepth;
+
+            const bool bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+            Tokenizer.Init(Input, bIndexed ? &StructuralIndex : nullptr);
+
+            if(ParseValue())
+            {
+                Root = Scratch.back();
+                
+                Consume();
+                if(CurrentToken.Type != JsonTokenType::None)
+                {
+                    ThrowError(CurrentToken, "Unexpected data after the root value");
+                    Root = {};
+                }
+            }
+            
+            Scratch.clear();
+            Tokenizer.Init("");
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+        [[nodiscard]] const JsonCompactValue& GetRoot() const
+        {
+            return Root;
+        }
+
+        const JsonCompactValue& operator[](std::string_view Key) const
+        {
+            return Root[Key];
+        }
+
+        const JsonCompactValue& operator[](size_t Index) const
+        {
+            return Root[Index];
+        }
+
+    private:
+        void Peek()
+        {
+            CurrentToken = Tokenizer.PeekToken();
+            if(CurrentToken.Type == JsonTokenType::Error)
+            {
+                ThrowError(CurrentToken, CurrentToken.Value);
+            }
+        }
+
+        void Consume()
+        {
+            CurrentToken = Tokenizer.GetToken();
+            if(CurrentToken.Type == JsonTokenType::Error)
+            {
+                ThrowError(CurrentToken, CurrentToken.Value);
+            }
+        }
+        
+        void ThrowError(const JsonToken& Token, std::string_view Message)
+        {
+            if(HasError()) return;
+            ErrorMessage = Tokenizer.FormatError(Token, Message);
+        }
+
+        JsonCompactValue MakeString(const JsonToken& Token)
+        {
+            const std::string Decoded = Token.bHasEscapes ? JsonTokenizer::DecodeString(Token) : std::string{};
+            const std::string_view String = Token.bHasEscapes ? std::string_view{Decoded} : Token.Value;
+            if(String.size() <= JsonCompactValue::MaxInlineSize)
+            {
+                return JsonCompactValue::MakeString(String);
+            }
+            
+            char* Data = static_cast<char*>(Arena->allocate(String.size(), 1));
+            std::memcpy(Data, String.data(), String.size());
+            return JsonCompactValue::MakeString({Data, String.size()});
+        }
+
+        // Moves the elements pushed since Start from the scratch stack into the arena
+        JsonCompactValue PopContainer(JsonCompactValue::Type ValueType, size_t Start)
+        {
+            const size_t Count = Scratch.size() - Start;
+            auto* Children = static_cast<JsonCompactValue*>(Arena->allocate(Count * sizeof(JsonCompactValue), alignof(JsonCompactValue)));
+            std::uninitialized_copy(Scratch.begin() + static_cast<ptrdiff_t>(Start), Scratch.end(), Children);
+            Scratch.resize(Start);
+
+            const size_t Size = ValueType == JsonCompactValue::Type::Object ? Count / 2 : Count;
+            return JsonCompactValue::MakeContainer(ValueType, Children, Size);
+        }
+
+        // Pushes the parsed value onto the scratch stack
+        bool ParseValue()
+        {
+            Peek();
+            switch(CurrentToken.Type)
+            {
+                case JsonTokenType::ObjectStart:
+                case JsonTokenType::ArrayStart:
+                {
+                    if(Depth >= MaxDepth)
+                    {
+                        ThrowParserError(CurrentToken, "Maximum nesting depth exceeded");
+                    }
+
+                    ++Depth;
+                    const bool bParsed = CurrentToken.Type == JsonTokenType::ObjectStart ? ParseObject() : ParseArray();
+                    --Depth;
+                    return bParsed;
+                }
+                case JsonTokenType::String:
+                {
+                    Consume();
+                    Scratch.push_back(MakeString(CurrentToken));
+                    return true;
+                }
+                case JsonTokenType::Number:
+                {
+                    Consume();
+                    Scratch.push_back(CurrentToken.bIsFloat ?
+                        JsonCompactValue::Make(JsonCompactValue::Type::Double, CurrentToken.Number.Float) :
+                        JsonCompactValue::Make(JsonCompactValue::Type::Integer, CurrentToken.Number.Integer));
+                    return true;
+                }
+                case JsonTokenType::Null:
+                {
+                    Consume();
+                    Scratch.push_back(JsonCompactValue::Make(JsonCompactValue::Type::Null, nullptr));
+                    return true;
+                }
+                case JsonTokenType::Boolean:
+                {
+                    Consume();
+                    Scratch.push_back(JsonCompactValue::Make(JsonCompactValue::Type::Boolean, CurrentToken.Value == "true"));
+                    return true;
+                }
+                default:;
+            }
+
+            ThrowParserError(CurrentToken, std::format("Unexpected token while parsing value: {}", CurrentToken.Value));
+        }
+
+        bool ParseArray()
+        {
+            Consume();
+            const size_t Start = Scratch.size();
+            
+            Peek();
+            if(CurrentToken.Type != JsonTokenType::ArrayEnd)
+            {
+                for(;;)
+                {
+                    if(!ParseValue()) return false;
+
+                    Consume();
+                    if(CurrentToken.Type == JsonTokenType::ArrayEnd) break;
+                    if(CurrentToken.Type != JsonTokenType::Comma)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ',' or ']'");
+                    }
+                }
+            }
+            else
+            {
+                Consume();
+            }
+
+            Scratch.push_back(PopContainer(JsonCompactValue::Type::Array, Start));
+            return true;
+        }
+
+        bool ParseObject()
+        {
+            Consume();
+            const size_t Start = Scratch.size();
+            
+            Peek();
+            if(CurrentToken.Type != JsonTokenType::ObjectEnd)
+            {
+                for(;;)
+                {
+                    Consume();
+                    if(CurrentToken.Type != JsonTokenType::String)
+                    {
+                        ThrowParserError(CurrentToken, "Expected string key");
+                    }
+                    Scratch.push_back(MakeString(CurrentToken));
+
+                    Consume();
+                    if(CurrentToken.Type != JsonTokenType::Colon)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ':'");
+                    }
+                    
+                    if(!ParseValue()) return false;
+
+                    Consume();
+                    if(CurrentToken.Type == JsonTokenType::ObjectEnd) break;
+                    if(CurrentToken.Type != JsonTokenType::Comma)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ',' or '}'");
+                    }
+                }
+            }
+            else
+            {
+                Consume();
+            }
+
+            Scratch.push_back(PopContainer(JsonCompactValue::Type::Object, Start));
+            return true;
+        }
+        
+        std::unique_ptr<JsonArena> Arena;
+        JsonCompactValue Root{};
+        
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        JsonToken CurrentToken{};
+        std::optional<std::string> ErrorMessage{};
+        std::vector<JsonCompactValue> Scratch{};
+        size_t Depth{};
+        size_t MaxDepth{};
+    };
+
+    // Read-only document storing the parse result as one contiguous tape of tagged 64-bit words.
+    // The top byte of a word is its tag, containers store the index past their end so whole subtrees are skipped in one step.
+    //  '{' / '[' : bits 0-31 index after the matching end word, bits 32-55 element count (saturated)
+    //  '}' / ']' : index of the matching start word
+    //  '"'       : offset of the string in the string buffer, stored as a 32-bit length followed by the characters
+    //  'l' / 'd' : int64_t / double, the value is stored in the next word
+    //  't' / 'f' / 'n' : true, false, null
+    class JsonTapeDocument
+    {
+    public:
+        using Type = JsonValueType;
+
+        class Ref;
+
+        // Forward iterator over the elements of an array or the properties of an object
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Ref;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ref;
+
+            Iterator() = default;
+            
+            Iterator(const JsonTapeDocument* Document, size_t Index, bool bObject) :
+            Document(Document),
+            Index(Index),
+            bObject(bObject)
+            {
+                
+            }
+
+            Ref operator*() const
+            {
+                return {Document, bObject ? Index + 1 : Index};
+            }
+
+            // Key of the current property when iterating an object
+            [[nodiscard]] std::string_view GetKey() const
+            {
+                return Document->GetString(Index);
+            }
+
+            Iterator& operator++()
+            {
+                if(bObject) ++Index;
+                Index = Document->Skip(Index);
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            bool operator==(const Iterator& Other) const
+            {
+                return Index == Other.Index;
+            }
+
+        private:
+            const JsonTapeDocument* Document{};
+            size_t Index{};
+            bool bObject{};
+        };
+
+        // Non-owning view of one value on the tape, same access API as JsonCompactValue
+        class Ref
+        {
+        public:
+            Ref() = default;
+            
+            Ref(const JsonTapeDocument* Document, size_t Index) :
+            Document(Document),
+            Index(Index)
+            {
+                
+            }
+
+            [[nodiscard]] Type GetType() const
+            {
+                if(!Document) return Type::Undefined;
+                switch(Document->GetTag(Index))
+                {
+                    case 'n': return Type::Null;
+                    case 't': case 'f': return Type::Boolean;
+                    case 'l': return Type::Integer;
+                    case 'd': return Type::Double;
+                    case '"': return Type::String;
+                    case '[': return Type::Array;
+                    case '{': return Type::Object;
+                    default: return Type::Undefined;
+                }
+            }
+
+            [[nodiscard]] bool IsUndefined() const { return GetType() == Type::Undefined; }
+            [[nodiscard]] bool IsNull() const { return GetType() == Type::Null; }
+            [[nodiscard]] bool IsArray() const { return GetType() == Type::Array; }
+            [[nodiscard]] bool IsObject() const { return GetType() == Type::Object; }
+
+            template<typename T>
+            [[nodiscard]] bool HasType() const
+            {
+                return Detail::IsValueTypeOf<T>(GetType());
+            }
+
+            template<typename T>
+            [[nodiscard]] T GetAs() const
+            {
+                if(!HasType<T>())
+                {
+                    throw std::runtime_error("Field is not of the requested type");
+                }
+
+                if constexpr(std::is_same_v<T, bool>) return Document->GetTag(Index) == 't';
+                else if constexpr(std::is_integral_v<T>) return static_cast<T>(static_cast<int64_t>(Document->Tape[Index + 1]));
+                else if constexpr(std::is_floating_point_v<T>) return static_cast<T>(std::bit_cast<double>(Document->Tape[Index + 1]));
+                else return T{Document->GetString(Index)};
+            }
+
+            template<typename T>
+            [[nodiscard]] T Or(T Default) const
+            {
+                return HasType<T>() ? GetAs<T>() : Default;
+            }
+
+            [[nodiscard]] std::string_view Or(const char* Default) const
+            {
+                return Or<std::string_view>(Default);
+            }
+
+            template<typename T>
+            requires(std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+            operator T() const
+            {
+                return GetAs<T>();
+            }
+
+            // Number of elements of an array or properties of an object, counted by walking the tape past 2^24 - 1
+            [[nodiscard]] size_t GetSize() const
+            {
+                if(!IsArray() && !IsObject()) return 0;
+                
+                const size_t Count = static_cast<size_t>((Document->GetPayload(Index) >> 32) & MaxStoredCount);
+                if(Count < MaxStoredCount) return Count;
+                return static_cast<size_t>(std::distance(begin(), end()));
+            }
+
+            Ref operator[](size_t ElementIndex) const
+            {
+                if(!IsArray()) return {};
+                
+                for(auto It = begin(); It != end(); ++It)
+                {
+                    if(ElementIndex-- == 0) return *It;
+                }
+                return {};
+            }
+
+            Ref operator[](std::string_view Key) const
+            {
+                if(!IsObject()) return {};
+                
+                for(auto It = begin(); It != end(); ++It)
+                {
+                    if(It.GetKey() == Key) return *It;
+                }
+                return {};
+            }
+
+            Ref operator[](const char* Key) const
+            {
+                return (*this)[std::string_view{Key}];
+            }
+
+            [[nodiscard]] Iterator begin() const
+            {
+                return {Document, Document ? Index + 1 : 0, IsObject()};
+            }
+
+            [[nodiscard]] Iterator end() const
+            {
+                const bool bContainer = IsArray() || IsObject();
+                return {Document, bContainer ? Document->Skip(Index) - 1 : (Document ? Index + 1 : 0), IsObject()};
+            }
+
+        private:
+            const JsonTapeDocument* Document{};
+            size_t Index{};
+        };
+        
+        JsonTapeDocument() = default;
+
+        // The input may be released after parsing, all strings are copied into the string buffer
+        void Parse(std::string_view Input, const JsonParseOptions& Options = {})
+        {
+            Tape.clear();
+            StringBuffer.clear();
+            ErrorMessage.reset();
+            Depth = 0;
+            MaxDepth = Options.MaxDepth;
+
+            const bool bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+            Tokenizer.Init(Input, bIndexed ? &StructuralIndex : nullptr);
+
+            // Every token takes at most one word except numbers, which are balanced by the separators around them, so the
+            // structural count is a close estimate. Without an index a small reservation is made and the tape grows as needed.
+            Tape.reserve(bIndexed ? StructuralIndex.GetPositions().size() + 2 : Input.size() / 32 + 4);
+
+            if(ParseValue())
+            {
+                Consume();
+                if(CurrentToken.Type != JsonTokenType::None)
+                {
+                    ThrowError(CurrentToken, "Unexpected data after the root value");
+                }
+            }
+
+            if(HasError())
+            {
+                Tape.clear();
+                StringBuffer.clear();
+            }
+            
+            Tokenizer.Init("");
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+        [[nodiscard]] Ref GetRoot() const
+        {
+            return Tape.empty() ? Ref{} : Ref{this, 0};
+        }
+
+        Ref operator[](std::string_view Key) const
+        {
+            return GetRoot()[Key];
+        }
+
+        Ref operator[](size_t Index) const
+        {
+            return GetRoot()[Index];
+        }
+
+        [[nodiscard]] std::span<const uint64_t> GetTape() const
+        {
+            return Tape;
+        }
+
+    private:
+        static constexpr uint64_t PayloadMask = (uint64_t{1} << 56) - 1;
+        static constexpr uint64_t MaxStoredCount = (uint64_t{1} << 24) - 1;
+
+        [[nodiscard]] char GetTag(size_t Index) const
+        {
+            return static_cast<char>(Tape[Index] >> 56);
+        }
+
+        [[nodiscard]] uint64_t GetPayload(size_t Index) const
+        {
+            return Tape[Index] & PayloadMask;
+        }
+
+        [[nodiscard]] std::string_view GetString(size_t Index) const
+        {
+            const size_t Offset = static_cast<size_t>(GetPayload(Index));
+            uint32_t Length;
+            std::memcpy(&Length, StringBuffer.data() + Offset, sizeof(Length));
+            return {StringBuffer.data() + Offset + sizeof(Length), Length};
+        }
+
+        // Index of the value following the one at Index
+        [[nodiscard]] size_t Skip(size_t Index) const
+        {
+            switch(GetTag(Index))
+            {
+                case '{': case '[': return static_cast<size_t>(GetPayload(Index) & 0xFFFFFFFF);
+                case 'l': case 'd': return Index + 2;
+                default: return Index + 1;
+            }
+        }
+
+        void Append(char Tag, uint64_t Payload = 0)
+        {
+            Tape.push_back((static_cast<uint64_t>(static_cast<uint8_t>(Tag)) << 56) | Payload);
+        }
+
+        void AppendString(const JsonToken& Token)
+        {
+            const size_t Offset = StringBuffer.size();
+            const std::string Decoded = Token.bHasEscapes ? JsonTokenizer::DecodeString(Token) : std::string{};
+            const std::string_view String = Token.bHasEscapes ? std::string_view{Decoded} : Token.Value;
+
+            const uint32_t Length = static_cast<uint32_t>(String.size());
+            StringBuffer.append(reinterpret_cast<const char*>(&Length), sizeof(Length));
+            StringBuffer.append(String);
+            
+            Append('"', Offset);
+        }
+
+        // Patches the start word once the container is closed
+        void CloseContainer(size_t Start, char EndTag, size_t Count)
+        {
+            Append(EndTag, Start);
+            Tape[Start] |= (static_cast<uint64_t>(std::min<size_t>(Count, MaxStoredCount)) << 32) | static_cast<uint64_t>(Tape.size());
+        }
+        
+        void Peek()
+        {
+            CurrentToken = Tokenizer.PeekToken();
+            if(CurrentToken.Type == JsonTokenType::Error)
+            {
+                ThrowError(CurrentToken, CurrentToken.Value);
+            }
+        }
+
+        void Consume()
+        {
+            CurrentToken = Tokenizer.GetToken();
+            if(CurrentToken.Type == JsonTokenType::Error)
+            {
+                ThrowError(CurrentToken, CurrentToken.Value);
+            }
+        }
+        
+        void ThrowError(const JsonToken& Token, std::string_view Message)
+        {
+            if(HasError()) return;
+            ErrorMessage = Tokenizer.FormatError(Token, Message);
+        }
+        
+        bool ParseValue()
+        {
+            Peek();
+            switch(CurrentToken.Type)
+            {
+                case JsonTokenType::ObjectStart:
+                case JsonTokenType::ArrayStart:
+                {
+                    if(Depth >= MaxDepth)
+                    {
+                        ThrowParserError(CurrentToken, "Maximum nesting depth exceeded");
+                    }
+
+                    ++Depth;
+                    const bool bParsed = CurrentToken.Type == JsonTokenType::ObjectStart ? ParseObject() : ParseArray();
+                    --Depth;
+                    return bParsed;
+                }
+                case JsonTokenType::String:
+                {
+                    Consume();
+                    AppendString(CurrentToken);
+                    return true;
+                }
+                case JsonTokenType::Number:
+                {
+                    Consume();
+                    if(CurrentToken.bIsFloat)
+                    {
+                        Append('d');
+                        Tape.push_back(std::bit_cast<uint64_t>(CurrentToken.Number.Float));
+                    }
+                    else
+                    {
+                        Append('l');
+                        Tape.push_back(static_cast<uint64_t>(CurrentToken.Number.Integer));
+                    }
+                    return true;
+                }
+                case JsonTokenType::Null:
+                {
+                    Consume();
+                    Append('n');
+                    return true;
+                }
+                case JsonTokenType::Boolean:
+                {
+                    Consume();
+                    Append(CurrentToken.Value == "true" ? 't' : 'f');
+                    return true;
+                }
+                default:;
+            }
+
+            ThrowParserError(CurrentToken, std::format("Unexpected token while parsing value: {}", CurrentToken.Value));
+        }
+
+        bool ParseArray()
+        {
+            Consume();
+            const size_t Start = Tape.size();
+            Append('[');
+
+            size_t Count{};
+            Peek();
+            if(CurrentToken.Type != JsonTokenType::ArrayEnd)
+            {
+                for(;; ++Count)
+                {
+                    if(!ParseValue()) return false;
+
+                    Consume();
+                    if(CurrentToken.Type == JsonTokenType::ArrayEnd) break;
+                    if(CurrentToken.Type != JsonTokenType::Comma)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ',' or ']'");
+                    }
+                }
+                ++Count;
+            }
+            else
+            {
+                Consume();
+            }
+
+            CloseContainer(Start, ']', Count);
+            return true;
+        }
+
+        bool ParseObject()
+        {
+            Consume();
+            const size_t Start = Tape.size();
+            Append('{');
+
+            size_t Count{};
+            Peek();
+            if(CurrentToken.Type != JsonTokenType::ObjectEnd)
+            {
+                for(;; ++Count)
+                {
+                    Consume();
+                    if(CurrentToken.Type != JsonTokenType::String)
+                    {
+                        ThrowParserError(CurrentToken, "Expected string key");
+                    }
+                    AppendString(CurrentToken);
+
+                    Consume();
+                    if(CurrentToken.Type != JsonTokenType::Colon)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ':'");
+                    }
+                    
+                    if(!ParseValue()) return false;
+
+                    Consume();
+                    if(CurrentToken.Type == JsonTokenType::ObjectEnd) break;
+                    if(CurrentToken.Type != JsonTokenType::Comma)
+                    {
+                        ThrowParserError(CurrentToken, "Expected ',' or '}'");
+                    }
+                }
+                ++Count;
+            }
+            else
+            {
+                Consume();
+            }
+
+            CloseContainer(Start, '}', Count);
+            return true;
+        }
+        
+        std::vector<uint64_t> Tape{};
+        std::string StringBuffer{};
+        
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        JsonToken CurrentToken{};
+        std::optional<std::string> ErrorMessage{};
+        size_t Depth{};
+        size_t MaxDepth{};
+    };
+
+    class JsonLazyDocument;
+
+    // View of a value of a JsonLazyDocument, only the parts of the input needed to answer a query are scanned.
+    // Same access API as JsonCompactValue.
+    class JsonLazyValue
+    {
+    public:
+        using Type = JsonValueType;
+        
+        // Forward iterator over the elements of an array or the properties of an object
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = JsonLazyValue;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = JsonLazyValue;
+
+            Iterator() = default;
+            
+            Iterator(JsonLazyDocument* Document, size_t Container, size_t Entry);
+
+            JsonLazyValue operator*() const;
+
+            // Key of the current property when iterating an object
+            [[nodiscard]] std::string_view GetKey() const;
+
+            Iterator& operator++();
+
+            Iterator operator++(int)
+            {
+                Iterator Previous = *this;
+                ++*this;
+                return Previous;
+            }
+
+            bool operator==(const Iterator& Other) const
+            {
+                return Entry == Other.Entry;
+            }
+
+        private:
+            JsonLazyDocument* Document{};
+            size_t Container{};
+            size_t Entry{};
+        };
+        
+        JsonLazyValue() = default;
+
+        JsonLazyValue(JsonLazyDocument* Document, size_t Position) :
+        Document(Document),
+        Position(Position)
+        {
+            
+        }
+
+        [[nodiscard]] Type GetType() const;
+
+        [[nodiscard]] bool IsUndefined() const { return GetType() == Type::Undefined; }
+        [[nodiscard]] bool IsNull() const { return GetType() == Type::Null; }
+        [[nodiscard]] bool IsArray() const { return GetType() == Type::Array; }
+        [[nodiscard]] bool IsObject() const { return GetType() == Type::Object; }
+
+        template<typename T>
+        [[nodiscard]] bool HasType() const
+        {
+            return Detail::IsValueTypeOf<T>(GetType());
+        }
+
+        // String views with escape sequences point to decoded copies owned by the document
+        template<typename T>
+        [[nodiscard]] T GetAs() const
+        {
+            const JsonToken Token = ReadScalar();
+            if(!Detail::IsValueTypeOf<T>(GetTokenValueType(Token)))
+            {
+                throw std::runtime_error("Field is not of the requested type");
+            }
+
+            if constexpr(std::is_same_v<T, bool>) return Token.Value == "true";
+            else if constexpr(std::is_integral_v<T>) return static_cast<T>(Token.Number.Integer);
+            else if constexpr(std::is_floating_point_v<T>) return static_cast<T>(Token.Number.Float);
+            else if constexpr(std::is_same_v<T, std::string>) return JsonTokenizer::DecodeString(Token);
+            else return GetStringView(Token);
+        }
+
+        template<typename T>
+        [[nodiscard]] T Or(T Default) const
+        {
+            return HasType<T>() ? GetAs<T>() : Default;
+        }
+
+        [[nodiscard]] std::string_view Or(const char* Default) const
+        {
+            return Or<std::string_view>(Default);
+        }
+
+        template<typename T>
+        requires(std::is_arithmetic_v<T> || std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+        operator T() const
+        {
+            return GetAs<T>();
+        }
+
+        // Scans the whole container
+        [[nodiscard]] size_t GetSize() const;
+
+        JsonLazyValue operator[](size_t Index) const;
+        JsonLazyValue operator[](std::string_view Key) const;
+
+        JsonLazyValue operator[](const char* Key) const
+        {
+            return (*this)[std::string_view{Key}];
+        }
+
+        [[nodiscard]] Iterator begin() const;
+        [[nodiscard]] Iterator end() const;
+
+        // Unparsed JSON text of the value, can be handed to a full parser to materialize the subtree
+        [[nodiscard]] std::string_view GetRaw() const;
+
+    private:
+        static Type GetTokenValueType(const JsonToken& Token)
+        {
+            switch(Token.Type)
+            {
+                case JsonTokenType::Null: return Type::Null;
+                case JsonTokenType::Boolean: return Type::Boolean;
+                case JsonTokenType::Number: return Token.bIsFloat ? Type::Double : Type::Integer;
+                case JsonTokenType::String: return Type::String;
+                case JsonTokenType::ArrayStart: return Type::Array;
+                case JsonTokenType::ObjectStart: return Type::Object;
+                default: return Type::Undefined;
+            }
+        }
+        
+        [[nodiscard]] JsonToken ReadScalar() const;
+        [[nodiscard]] std::string_view GetStringView(const JsonToken& Token) const;
+        
+        JsonLazyDocument* Document{};
+        size_t Position{};
+    };
+
+    // On-demand document: Parse only records the input, lookups scan forward just far enough to find the requested field
+    // and skip uninteresting subtrees without building values. Scan progress is memorized per container
+    // so repeated lookups never rescan. Skipped subtrees only have their token order checked, their literals and numbers are
+    // validated once they are read. Parse rejects data after the root unless it ends in a closing bracket, which is reported
+    // once a scan reaches the end of the root.
+    class JsonLazyDocument
+    {
+    public:
+        JsonLazyDocument() = default;
+
+        JsonLazyDocument(const JsonLazyDocument& Other) = delete;
+        JsonLazyDocument& operator=(const JsonLazyDocument& Other) = delete;
+
+        // The input must outlive the document, values reference it directly.
+        // With bUseStructuralIndex skipped subtrees are matched on the index instead of the raw input.
+        void Parse(std::string_view InputIn, const JsonParseOptions& Options = {})
+        {
+            // Any mapping of a previous ParseFile is released, InputIn may not point into it
+            File.Close();
+            
+            Input = InputIn;
+            Tokenizer.Init(Input);
+            Containers.clear();
+            DecodedStrings.clear();
+            DecodedValues.clear();
+            ErrorMessage.reset();
+            
+            bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+
+            RootPosition = SkipWhitespace(0);
+            if(RootPosition >= Input.size())
+            {
+                ThrowError({JsonTokenType::None, RootPosition, ""}, "Empty document");
+                return;
+            }
+
+            // A container root must be the last value, its closing bracket ends the input. Only on a mismatch is the root
+            // skipped to find where the trailing data starts, a root completed by a later scan is checked again then.
+            size_t Last = Input.size() - 1;
+            while(Last > RootPosition && Detail::IsJsonWhitespace(Input[Last])) --Last;
+            
+            const char First = Input[RootPosition];
+            if((First != '{' && First != '[') || Input[Last] != (First == '{' ? '}' : ']'))
+            {
+                if(const size_t End = SkipValue(RootPosition); End != InvalidPosition)
+                {
+                    CheckRootEnd(End);
+                }
+            }
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+        // Maps the file and keeps the mapping for the lifetime of the document, values reference it directly
+        void ParseFile(const std::string& Path, const JsonParseOptions& Options = {})
+        {
+            JsonMappedFile NewFile;
+            if(!NewFile.Open(Path))
+            {
+                Parse({}, Options);
+                ErrorMessage = std::string(NewFile.GetError());
+                return;
+            }
+
+            Parse(NewFile.GetData(), Options);
+            File = std::move(NewFile);
+        }
+
+        [[nodiscard]] JsonLazyValue GetRoot()
+        {
+            return RootPosition < Input.size() ? JsonLazyValue{this, RootPosition} : JsonLazyValue{};
+        }
+
+        JsonLazyValue operator[](std::string_view Key)
+        {
+            return GetRoot()[Key];
+        }
+
+        JsonLazyValue operator[](size_t Index)
+        {
+            return GetRoot()[Index];
+        }
+
+    private:
+        friend class JsonLazyValue;
+        
+        static constexpr size_t InvalidPosition = std::numeric_limits<size_t>::max();
+
+        struct Entry
+        {
+            std::string_view Key{};
+            size_t Position{};
+        };
+
+        // Scan progress of one array or object
+        struct ContainerScan
+        {
+            std::vector<Entry> Entries{};
+            size_t Resume{};
+            bool bObject{};
+            bool bRoot{};
+            bool bComplete{};
+        };
+
+        size_t SkipWhitespace(size_t Offset) const
+        {
+            while(Offset < Input.size() && Detail::IsJsonWhitespace(Input[Offset])) ++Offset;
+            return Offset;
+        }
+
+        // Only whitespace may follow the root value ending at End
+        void CheckRootEnd(size_t End)
+        {
+            if(const size_t Position = SkipWhitespace(End); Position < Input.size())
+            {
+                ThrowError({JsonTokenType::Error, Position, Input.substr(Position, 1)}, "Unexpected data after the root value");
+            }
+        }
+
+        void ThrowError(const JsonToken& Token, std::string_view Message)
+        {
+            if(HasError()) return;
+            ErrorMessage = Tokenizer.FormatError(Token, Message);
+        }
+
+        // Checks the token order inside a skipped container, the scalars themselves are not validated.
+        // States know whether they are inside an object or an array, so only closing a container needs the kind of its parent.
+        // The kinds of the first 64 levels are kept in a bit mask, deeper levels spill into Overflow.
+        class SkipGrammar
+        {
+        public:
+            explicit SkipGrammar(std::vector<char>& OverflowIn) :
+            Overflow(OverflowIn)
+            {
+                Overflow.clear();
+            }
+
+            // Char is a structural character, '"' for a string or any other character for a literal or number.
+            // Returns false if the token can't follow the previous one.
+            bool Step(char Char)
+            {
+                const uint8_t Next = Transitions[State][CharClasses[static_cast<uint8_t>(Char)]];
+                switch(Next)
+                {
+                    case Invalid: return false;
+                    case Close:
+                    {
+                        --Depth;
+                        if(Depth == 0) State = Done;
+                        else if(Depth < 64) State = (Kinds >> (Depth - 1)) & 1 ? ObjectCommaOrEnd : ArrayCommaOrEnd;
+                        else
+                        {
+                            Overflow.pop_back();
+                            State = Depth == 64 ? ((Kinds >> 63) & 1 ? ObjectCommaOrEnd : ArrayCommaOrEnd) : (Overflow.back() ? ObjectCommaOrEnd : ArrayCommaOrEnd);
+                        }
+                        return true;
+                    }
+                    case ObjectKeyOrEnd: case ArrayValueOrEnd:
+                    {
+                        const bool bObject = Next == ObjectKeyOrEnd;
+                        if(Depth < 64)
+                        {
+                            Kinds = bObject ? Kinds | (uint64_t{1} << Depth) : Kinds & ~(uint64_t{1} << Depth);
+                        }
+                        else
+                        {
+                            Overflow.push_back(bObject);
+                        }
+                        ++Depth;
+                        [[fallthrough]];
+                    }
+                    default:
+                    {
+                        State = Next;
+                        return true;
+                    }
+                }
+            }
+
+            [[nodiscard]] bool IsComplete() const
+            {
+                return State == Done;
+            }
+
+        private:
+            enum : uint8_t
+            {
+                RootValue,
+                ObjectKeyOrEnd,
+                ObjectKey,
+                ObjectColon,
+                ObjectValue,
+                ObjectCommaOrEnd,
+                ArrayValueOrEnd,
+                ArrayValue,
+                ArrayCommaOrEnd,
+                Done,
+                StateCount,
+                Invalid = StateCount,
+                Close
+            };
+
+            enum : uint8_t
+            {
+                ClassObjectStart,
+                ClassArrayStart,
+                ClassObjectEnd,
+                ClassArrayEnd,
+                ClassComma,
+                ClassColon,
+                ClassString,
+                ClassScalar,
+                ClassCount
+            };
+
+            static constexpr std::array<uint8_t, 256> CharClasses = []()
+            {
+                std::array<uint8_t, 256> Result{};
+                Result.fill(ClassScalar);
+                Result['{'] = ClassObjectStart;
+                Result['['] = ClassArrayStart;
+                Result['}'] = ClassObjectEnd;
+                Result[']'] = ClassArrayEnd;
+                Result[','] = ClassComma;
+                Result[':'] = ClassColon;
+                Result['"'] = ClassString;
+                return Result;
+            }();
+
+            static constexpr std::array<std::array<uint8_t, ClassCount>, StateCount> Transitions = []()
+            {
+                std::array<std::array<uint8_t, ClassCount>, StateCount> Result{};
+                for(auto& Row : Result)
+                {
+                    Row.fill(Invalid);
+                }
+
+                auto AllowValue = [&](uint8_t From, uint8_t After)
+                {
+                    Result[From][ClassObjectStart] = ObjectKeyOrEnd;
+                    Result[From][ClassArrayStart] = ArrayValueOrEnd;
+                    Result[From][ClassString] = After;
+                    Result[From][ClassScalar] = After;
+                };
+
+                AllowValue(RootValue, Done);
+                AllowValue(ObjectValue, ObjectCommaOrEnd);
+                AllowValue(ArrayValue, ArrayCommaOrEnd);
+                AllowValue(ArrayValueOrEnd, ArrayCommaOrEnd);
+                
+                Result[ObjectKeyOrEnd][ClassString] = ObjectColon;
+                Result[ObjectKeyOrEnd][ClassObjectEnd] = Close;
+                Result[ObjectKey][ClassString] = ObjectColon;
+                Result[ObjectColon][ClassColon] = ObjectValue;
+                Result[ObjectCommaOrEnd][ClassComma] = ObjectKey;
+                Result[ObjectCommaOrEnd][ClassObjectEnd] = Close;
+                Result[ArrayValueOrEnd][ClassArrayEnd] = Close;
+                Result[ArrayCommaOrEnd][ClassComma] = ArrayValue;
+                Result[ArrayCommaOrEnd][ClassArrayEnd] = Close;
+                return Result;
+            }();
+            
+            std::vector<char>& Overflow;
+            uint64_t Kinds{};
+            size_t Depth{};
+            uint8_t State{RootValue};
+        };
+
+        // Position after the value starting at Offset, InvalidPosition on error
+        size_t SkipValue(size_t Offset)
+        {
+            const char First = Input[Offset];
+            if(First != '{' && First != '[')
+            {
+                const JsonToken Token = Tokenizer.ReadToken(Offset);
+                switch(Token.Type)
+                {
+                    case JsonTokenType::String: case JsonTokenType::Number: case JsonTokenType::Boolean: case JsonTokenType::Null: return Offset;
+                    case JsonTokenType::Error: ThrowError(Token, Token.Value); return InvalidPosition;
+                    default: ThrowError(Token, "Expected value"); return InvalidPosition;
+                }
+            }
+
+            SkipGrammar Grammar{SkipStack};
+            if(bIndexed)
+            {
+                const auto Positions = StructuralIndex.GetPositions();
+                for(auto It = std::lower_bound(Positions.begin(), Positions.end(), static_cast<uint32_t>(Offset)); It != Positions.end(); ++It)
+                {
+                    if(!Grammar.Step(Input[*It]))
+                    {
+                        ThrowError({JsonTokenType::Error, *It, Input.substr(*It, 1)}, "Unexpected token in container");
+                        return InvalidPosition;
+                    }
+                    if(Grammar.IsComplete()) return *It + 1;
+                }
+            }
+            else
+            {
+                const char* const Begin = Input.data();
+                const char* const End = Begin + Input.size();
+                for(const char* Current = Begin + Offset; Current < End; ++Current)
+                {
+                    const char Char = *Current;
+                    if(Detail::IsJsonWhitespace(Char)) continue;
+                    
+                    if(!Grammar.Step(Char))
+                    {
+                        const size_t Position = static_cast<size_t>(Current - Begin);
+                        ThrowError({JsonTokenType::Error, Position, Input.substr(Position, 1)}, "Unexpected token in container");
+                        return InvalidPosition;
+                    }
+                    
+                    switch(Char)
+                    {
+                        case '{': case '[': case ',': case ':': break;
+                        case '}': case ']':
+                        {
+                            if(Grammar.IsComplete()) return static_cast<size_t>(Current - Begin) + 1;
+                            break;
+                        }
+                        case '"':
+                        {
+                            // Jump to the closing quote, stepping over escaped characters
+                            for(Current = Detail::FindQuoteOrBackslash(Current + 1, End); Current < End && *Current == '\\'; )
+                            {
+                                Current = Detail::FindQuoteOrBackslash(std::min(Current + 2, End), End);
+                            }
+                            break;
+                        }
+                        default:
+                        {
+                            // Literal or number, skipped up to the next delimiter
+                            static constexpr std::array<bool, 256> IsDelimiter = []()
+                            {
+                                std::array<bool, 256> Result{};
+                                for(const char Delimiter : std::string_view{",:[]{}\" \t\n\r"})
+                                {
+                                    Result[static_cast<uint8_t>(Delimiter)] = true;
+                                }
+                                return Result;
+                            }();
+                            
+                            while(Current + 1 < End && !IsDelimiter[static_cast<uint8_t>(Current[1])]) ++Current;
+                        }
+                    }
+                }
+            }
+
+            ThrowError({JsonTokenType::Error, Offset, ""}, "Unterminated container");
+            return InvalidPosition;
+        }
+
+        ContainerScan* GetScan(size_t Container)
+        {
+            auto [It, bInserted] = Containers.try_emplace(Container);
+            if(bInserted)
+            {
+                It->second.Resume = Container + 1;
+                It->second.bObject = Input[Container] == '{';
+                It->second.bRoot = Container == RootPosition;
+            }
+            return &It->second;
+        }
+
+        // Scans one more element of the container, returns false once the end is reached or on error
+        bool ScanNext(ContainerScan& Scan)
+        {
+            if(Scan.bComplete) return false;
+
+            const JsonTokenType EndType = Scan.bObject ? JsonTokenType::ObjectEnd : JsonTokenType::ArrayEnd;
+            size_t Offset = Scan.Resume;
+            JsonToken Token = Tokenizer.ReadToken(Offset);
+
+            if(Token.Type == EndType)
+            {
+                Scan.bComplete = true;
+                if(Scan.bRoot)
+                {
+                    CheckRootEnd(Offset);
+                }
+                return false;
+            }
+
+            if(!Scan.Entries.empty())
+            {
+                if(Token.Type != JsonTokenType::Comma)
+                {
+                    ThrowError(Token, Token.Type == JsonTokenType::Error ? Token.Value : (Scan.bObject ? "Expected ',' or '}'" : "Expected ',' or ']'"));
+                    Scan.bComplete = true;
+                    return false;
+                }
+                Token = Tokenizer.ReadToken(Offset);
+            }
+
+            Entry NewEntry{};
+            if(Scan.bObject)
+            {
+                if(Token.Type != JsonTokenType::String)
+                {
+                    ThrowError(Token, Token.Type == JsonTokenType::Error ? Token.Value : "Expected string key");
+                    Scan.bComplete = true;
+                    return false;
+                }
+                NewEntry.Key = Token.bHasEscapes ? std::string_view{DecodedStrings.emplace_back(JsonTokenizer::DecodeString(Token))} : Token.Value;
+
+                Token = Tokenizer.ReadToken(Offset);
+                if(Token.Type != JsonTokenType::Colon)
+                {
+                    ThrowError(Token, Token.Type == JsonTokenType::Error ? Token.Value : "Expected ':'");
+                    Scan.bComplete = true;
+                    return false;
+                }
+                Offset = SkipWhitespace(Offset);
+            }
+            else
+            {
+                // The token read ahead starts the element
+                Offset = Token.Position;
+            }
+
+            NewEntry.Position = Offset;
+            if(Offset >= Input.size() || (Offset = SkipValue(Offset)) == InvalidPosition)
+            {
+                ThrowError({JsonTokenType::None, NewEntry.Position, ""}, "Expected value");
+                Scan.bComplete = true;
+                return false;
+            }
+
+            Scan.Entries.push_back(NewEntry);
+            Scan.Resume = Offset;
+            return true;
+        }
+
+        // Entry at Index, scanning further if needed, nullptr if the container is shorter
+        const Entry* GetEntry(size_t Container, size_t Index)
+        {
+            ContainerScan* Scan = GetScan(Container);
+            while(Scan->Entries.size() <= Index)
+            {
+                if(!ScanNext(*Scan)) return nullptr;
+            }
+            return &Scan->Entries[Index];
+        }
+
+        const Entry* FindEntry(size_t Container, std::string_view Key)
+        {
+            ContainerScan* Scan = GetScan(Container);
+            for(const Entry& Existing : Scan->Entries)
+            {
+                if(Existing.Key == Key) return &Existing;
+            }
+
+            while(ScanNext(*Scan))
+            {
+                if(Scan->Entries.back().Key == Key) return &Scan->Entries.back();
+            }
+            return nullptr;
+        }
+        
+        std::string_view Input{};
+        size_t RootPosition{};
+        bool bIndexed{};
+        JsonMappedFile File;
+
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        std::unordered_map<size_t, ContainerScan> Containers{};
+        std::deque<std::string> DecodedStrings{};
+        std::unordered_map<size_t, std::string_view> DecodedValues{};
+        std::vector<char> SkipStack{};
+        std::optional<std::string> ErrorMessage{};
+    };
+
+    inline JsonLazyValue::Iterator::Iterator(JsonLazyDocument* Document, size_t Container, size_t Entry) :
+    Document(Document),
+    Container(Container),
+    Entry(Entry)
+    {
+        if(Document && !Document->GetEntry(Container, Entry))
+        {
+            this->Entry = JsonLazyDocument::InvalidPosition;
+        }
+    }
+
+    inline JsonLazyValue JsonLazyValue::Iterator::operator*() const
+    {
+        return {Document, Document->GetEntry(Container, Entry)->Position};
+    }
+
+    inline std::string_view JsonLazyValue::Iterator::GetKey() const
+    {
+        return Document->GetEntry(Container, Entry)->Key;
+    }
+
+    inline JsonLazyValue::Iterator& JsonLazyValue::Iterator::operator++()
+    {
+        if(!Document->GetEntry(Container, ++Entry))
+        {
+            Entry = JsonLazyDocument::InvalidPosition;
+        }
+        return *this;
+    }
+
+    inline JsonValueType JsonLazyValue::GetType() const
+    {
+        if(!Document) return Type::Undefined;
+        switch(Document->Input[Position])
+        {
+            case '{': return Type::Object;
+            case '[': return Type::Array;
+            case '"': return Type::String;
+            case 't': case 'f': return Type::Boolean;
+            case 'n': return Type::Null;
+            default: return GetTokenValueType(ReadScalar());
+        }
+    }
+
+    inline JsonToken JsonLazyValue::ReadScalar() const
+    {
+        if(!Document) return {JsonTokenType::None, 0, ""};
+        
+        size_t Offset = Position;
+        const JsonToken Token = Document->Tokenizer.ReadToken(Offset);
+        if(Token.Type == JsonTokenType::Error)
+        {
+            Document->ThrowError(Token, Token.Value);
+        }
+        return Token;
+    }
+
+    inline std::string_view JsonLazyValue::GetStringView(const JsonToken& Token) const
+    {
+        if(!Token.bHasEscapes) return Token.Value;
+
+        // Decoded once per value, repeated reads return the same copy
+        auto [It, bInserted] = Document->DecodedValues.try_emplace(Position);
+        if(bInserted)
+        {
+            It->second = Document->DecodedStrings.emplace_back(JsonTokenizer::DecodeString(Token));
+        }
+        return It->second;
+    }
+
+    inline size_t JsonLazyValue::GetSize() const
+    {
+        if(!IsArray() && !IsObject()) return 0;
+
+        JsonLazyDocument::ContainerScan* Scan = Document->GetScan(Position);
+        while(Document->ScanNext(*Scan)) {}
+        return Scan->Entries.size();
+    }
+
+    inline JsonLazyValue JsonLazyValue::operator[](size_t Index) const
+    {
+        if(!IsArray()) return {};
+        
+        const auto* Entry = Document->GetEntry(Position, Index);
+        return Entry ? JsonLazyValue{Document, Entry->Position} : JsonLazyValue{};
+    }
+
+    inline JsonLazyValue JsonLazyValue::operator[](std::string_view Key) const
+    {
+        if(!IsObject()) return {};
+        
+        const auto* Entry = Document->FindEntry(Position, Key);
+        return Entry ? JsonLazyValue{Document, Entry->Position} : JsonLazyValue{};
+    }
+
+    inline JsonLazyValue::Iterator JsonLazyValue::begin() const
+    {
+        if(!IsArray() && !IsObject()) return end();
+        return {Document, Position, 0};
+    }
+
+    inline JsonLazyValue::Iterator JsonLazyValue::end() const
+    {
+        return {nullptr, Position, JsonLazyDocument::InvalidPosition};
+    }
+
+    inline std::string_view JsonLazyValue::GetRaw() const
+    {
+        if(!Document) return {};
+        
+        const size_t End = Document->SkipValue(Position);
+        if(End == JsonLazyDocument::InvalidPosition) return {};
+
+        // Scalars are followed by the whitespace consumed by the tokenizer
+        std::string_view Raw = Document->Input.substr(Position, End - Position);
+        while(!Raw.empty() && Detail::IsJsonWhitespace(Raw.back())) Raw.remove_suffix(1);
+        return Raw;
+    }
+
+    // Push-style consumer for JsonEventParser. Every callback returns false to stop parsing early.
+    // Strings and keys are views that are only valid during the call.
+    template<typename T>
+    concept CJsonEventHandler = requires(T& Handler, std::string_view String, int64_t Integer, double Float, bool bValue)
+    {
+        { Handler.OnObjectStart() } -> std::convertible_to<bool>;
+        { Handler.OnObjectEnd() } -> std::convertible_to<bool>;
+        { Handler.OnArrayStart() } -> std::convertible_to<bool>;
+        { Handler.OnArrayEnd() } -> std::convertible_to<bool>;
+        { Handler.OnKey(String) } -> std::convertible_to<bool>;
+        { Handler.OnString(String) } -> std::convertible_to<bool>;
+        { Handler.OnInt64(Integer) } -> std::convertible_to<bool>;
+        { Handler.OnDouble(Float) } -> std::convertible_to<bool>;
+        { Handler.OnBool(bValue) } -> std::convertible_to<bool>;
+        { Handler.OnNull() } -> std::convertible_to<bool>;
+    };
+
+    // Optional base for handlers which only care about some of the events, hidden rather than overridden so calls stay static
+    struct JsonEventHandler
+    {
+        bool OnObjectStart() { return true; }
+        bool OnObjectEnd() { return true; }
+        bool OnArrayStart() { return true; }
+        bool OnArrayEnd() { return true; }
+        bool OnKey(std::string_view) { return true; }
+        bool OnString(std::string_view) { return true; }
+        bool OnInt64(int64_t) { return true; }
+        bool OnDouble(double) { return true; }
+        bool OnBool(bool) { return true; }
+        bool OnNull() { return true; }
+    };
+
+    // Drives a handler straight from the tokenizer without building a document, memory use only grows with nesting depth
+    class JsonEventParser
+    {
+    public:
+        // Returns true when the whole input was consumed, false on error or when the handler stopped
+        template<CJsonEventHandler THandler>
+        bool Parse(std::string_view Input, THandler& Handler, const JsonParseOptions& Options = {})
+        {
+            const bool bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+            Tokenizer.Init(Input, bIndexed ? &StructuralIndex : nullptr);
+            ErrorMessage.reset();
+            Stack.clear();
+
+            JsonToken Token = NextToken();
+            for(;;)
+            {
+                // Token starts a value
+                if((Token.Type == JsonTokenType::ObjectStart || Token.Type == JsonTokenType::ArrayStart) && Stack.size() >= Options.MaxDepth)
+                {
+                    return Fail(Token, "Maximum nesting depth exceeded");
+                }
+                
+                switch(Token.Type)
+                {
+                    case JsonTokenType::ObjectStart:
+                    {
+                        if(!Handler.OnObjectStart()) return false;
+
+                        Token = NextToken();
+                        if(Token.Type == JsonTokenType::ObjectEnd)
+                        {
+                            if(!Handler.OnObjectEnd()) return false;
+                            break;
+                        }
+
+                        Stack.push_back(JsonTokenType::ObjectStart);
+                        if(!ParseKey(Token, Handler)) return false;
+                        
+                        Token = CurrentToken;
+                        continue;
+                    }
+                    case JsonTokenType::ArrayStart:
+                    {
+                        if(!Handler.OnArrayStart()) return false;
+
+                        Token = NextToken();
+                        if(Token.Type == JsonTokenType::ArrayEnd)
+                        {
+                            if(!Handler.OnArrayEnd()) return false;
+                            break;
+                        }
+
+                        Stack.push_back(JsonTokenType::ArrayStart);
+                        continue;
+                    }
+                    case JsonTokenType::String:
+                    {
+                        if(!Handler.OnString(GetStringView(Token))) return false;
+                        break;
+                    }
+                    case JsonTokenType::Number:
+                    {
+                        if(!(Token.bIsFloat ? Handler.OnDouble(Token.Number.Float) : Handler.OnInt64(Token.Number.Integer))) return false;
+                        break;
+                    }
+                    case JsonTokenType::Boolean:
+                    {
+                        if(!Handler.OnBool(Token.Value == "true")) return false;
+                        break;
+                    }
+                    case JsonTokenType::Null:
+                    {
+                        if(!Handler.OnNull()) return false;
+                        break;
+                    }
+                    default:
+                    {
+                        return Fail(Token, std::format("Unexpected token while parsing value: {}", Token.Value));
+                    }
+                }
+
+                // A value is complete, close containers until the next value starts
+                for(;;)
+                {
+                    Token = NextToken();
+                    if(Stack.empty())
+                    {
+                        if(Token.Type != JsonTokenType::None)
+                        {
+                            return Fail(Token, "Unexpected data after the root value");
+                        }
+                        return true;
+                    }
+
+                    if(Stack.back() == JsonTokenType::ObjectStart)
+                    {
+                        if(Token.Type == JsonTokenType::Comma)
+                        {
+                            if(!ParseKey(NextToken(), Handler)) return false;
+                            
+                            Token = CurrentToken;
+                            break;
+                        }
+                        if(Token.Type != JsonTokenType::ObjectEnd)
+                        {
+                            return Fail(Token, "Expected ',' or '}'");
+                        }
+
+                        Stack.pop_back();
+                        if(!Handler.OnObjectEnd()) return false;
+                    }
+                    else
+                    {
+                        if(Token.Type == JsonTokenType::Comma)
+                        {
+                            Token = NextToken();
+                            break;
+                        }
+                        if(Token.Type != JsonTokenType::ArrayEnd)
+                        {
+                            return Fail(Token, "Expected ',' or ']'");
+                        }
+
+                        Stack.pop_back();
+                        if(!Handler.OnArrayEnd()) return false;
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+    private:
+        JsonToken NextToken()
+        {
+            CurrentToken = Tokenizer.GetToken();
+            return CurrentToken;
+        }
+
+        std::string_view GetStringView(const JsonToken& Token)
+        {
+            if(!Token.bHasEscapes) return Token.Value;
+
+            Scratch = JsonTokenizer::DecodeString(Token);
+            return Scratch;
+        }
+
+        // Reads "key": and leaves the first token of the value in CurrentToken
+        template<typename THandler>
+        bool ParseKey(const JsonToken& Token, THandler& Handler)
+        {
+            if(Token.Type != JsonTokenType::String)
+            {
+                return Fail(Token, "Expected string key");
+            }
+            if(!Handler.OnKey(GetStringView(Token))) return false;
+
+            const JsonToken Colon = NextToken();
+            if(Colon.Type != JsonTokenType::Colon)
+            {
+                return Fail(Colon, "Expected ':'");
+            }
+
+            NextToken();
+            return true;
+        }
+
+        bool Fail(const JsonToken& Token, std::string_view Message)
+        {
+            if(!HasError())
+            {
+                ErrorMessage = Tokenizer.FormatError(Token, Token.Type == JsonTokenType::Error ? Token.Value : Message);
+            }
+            return false;
+        }
+
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        JsonToken CurrentToken{};
+        std::vector<JsonTokenType> Stack{};
+        std::string Scratch{};
+        std::optional<std::string> ErrorMessage{};
+    };
+
+    enum class JsonReaderEvent : uint8_t
+    {
+        None,
+        ObjectStart,
+        ObjectEnd,
+        ArrayStart,
+        ArrayEnd,
+        Key,
+        String,
+        Integer,
+        Double,
+        Boolean,
+        Null,
+        End,
+        Error
+    };
+
+    // Pull cursor over the input: every Next call reads one event, nothing is allocated per token.
+    // Callers can skip whole subtrees and stop at any point.
+    class JsonReader
+    {
+    public:
+        // The input must outlive the reader
+        void Init(std::string_view Input, const JsonParseOptions& Options = {})
+        {
+            const bool bIndexed = Options.bUseStructuralIndex && StructuralIndex.Build(Input);
+            Tokenizer.Init(Input, bIndexed ? &StructuralIndex : nullptr);
+            ErrorMessage.reset();
+            Stack.clear();
+            
+            Event = JsonReaderEvent::None;
+            State = ReaderState::Value;
+            Depth = 0;
+            MaxDepth = Options.MaxDepth;
+        }
+
+        // Moves to the next event, false once the end of the input is reached or on error
+        bool Next()
+        {
+            if(Event == JsonReaderEvent::End || Event == JsonReaderEvent::Error) return false;
+
+            Token = Tokenizer.GetToken();
+            switch(State)
+            {
+                case ReaderState::Value:
+                {
+                    return ReadValue();
+                }
+                case ReaderState::FirstElement:
+                {
+                    return Token.Type == JsonTokenType::ArrayEnd ? CloseContainer() : ReadValue();
+                }
+                case ReaderState::FirstKey:
+                {
+                    return Token.Type == JsonTokenType::ObjectEnd ? CloseContainer() : ReadKey();
+                }
+                case ReaderState::AfterValue:
+                {
+                    if(Stack.empty())
+                    {
+                        if(Token.Type != JsonTokenType::None)
+                        {
+                            return Fail("Unexpected data after the root value");
+                        }
+                        
+                        Event = JsonReaderEvent::End;
+                        return false;
+                    }
+
+                    const bool bObject = Stack.back() == JsonTokenType::ObjectStart;
+                    if(Token.Type == JsonTokenType::Comma)
+                    {
+                        Token = Tokenizer.GetToken();
+                        return bObject ? ReadKey() : ReadValue();
+                    }
+                    if(Token.Type != (bObject ? JsonTokenType::ObjectEnd : JsonTokenType::ArrayEnd))
+                    {
+                        return Fail(bObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+                    }
+                    return CloseContainer();
+                }
+            }
+            return false;
+        }
+
+        // Skips the value of the current key, or the rest of the container that was just entered.
+        // The reader is left on the last event of the skipped value.
+        bool SkipValue()
+        {
+            if(Event == JsonReaderEvent::Key && !Next()) return false;
+            if(Event != JsonReaderEvent::ObjectStart && Event != JsonReaderEvent::ArrayStart) return !HasError();
+
+            const size_t TargetDepth = Depth;
+            while(Next())
+            {
+                if((Event == JsonReaderEvent::ObjectEnd || Event == JsonReaderEvent::ArrayEnd) && Depth == TargetDepth) return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] JsonReaderEvent GetType() const
+        {
+            return Event;
+        }
+
+        // Number of containers enclosing the current event, container start and end events count the container itself out
+        [[nodiscard]] size_t GetDepth() const
+        {
+            return Depth;
+        }
+
+        // Current key or string, only valid until the next call to Next
+        [[nodiscard]] std::string_view GetString()
+        {
+            if(!Token.bHasEscapes) return Token.Value;
+
+            Scratch = JsonTokenizer::DecodeString(Token);
+            return Scratch;
+        }
+
+        // Doubles are truncated and saturated to the int64_t range, NaN yields 0
+        [[nodiscard]] int64_t GetInt64() const
+        {
+            if(Event != JsonReaderEvent::Double) return Token.Number.Integer;
+
+            const double Float = Token.Number.Float;
+            if(std::isnan(Float)) return 0;
+            if(Float <= -0x1p63) return std::numeric_limits<int64_t>::min();
+            if(Float >= 0x1p63) return std::numeric_limits<int64_t>::max();
+            return static_cast<int64_t>(Float);
+        }
+
+        [[nodiscard]] double GetDouble() const
+        {
+            return Event == JsonReaderEvent::Integer ? static_cast<double>(Token.Number.Integer) : Token.Number.Float;
+        }
+
+        [[nodiscard]] bool GetBool() const
+        {
+            return Token.Value == "true";
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+    private:
+        enum class ReaderState : uint8_t
+        {
+            Value,
+            FirstElement,
+            FirstKey,
+            AfterValue
+        };
+        
+        bool ReadValue()
+        {
+            Depth = Stack.size();
+            State = ReaderState::AfterValue;
+
+            if((Token.Type == JsonTokenType::ObjectStart || Token.Type == JsonTokenType::ArrayStart) && Depth >= MaxDepth)
+            {
+                return Fail("Maximum nesting depth exceeded");
+            }
+            
+            switch(Token.Type)
+            {
+                case JsonTokenType::ObjectStart:
+                {
+                    Stack.push_back(JsonTokenType::ObjectStart);
+                    State = ReaderState::FirstKey;
+                    Event = JsonReaderEvent::ObjectStart;
+                    return true;
+                }
+                case JsonTokenType::ArrayStart:
+                {
+                    Stack.push_back(JsonTokenType::ArrayStart);
+                    State = ReaderState::FirstElement;
+                    Event = JsonReaderEvent::ArrayStart;
+                    return true;
+                }
+                case JsonTokenType::String: Event = JsonReaderEvent::String; return true;
+                case JsonTokenType::Number: Event = Token.bIsFloat ? JsonReaderEvent::Double : JsonReaderEvent::Integer; return true;
+                case JsonTokenType::Boolean: Event = JsonReaderEvent::Boolean; return true;
+                case JsonTokenType::Null: Event = JsonReaderEvent::Null; return true;
+                default:;
+            }
+
+            return Fail(std::format("Unexpected token while parsing value: {}", Token.Value));
+        }
+
+        bool ReadKey()
+        {
+            if(Token.Type != JsonTokenType::String)
+            {
+                return Fail("Expected string key");
+            }
+
+            if(Tokenizer.PeekToken().Type != JsonTokenType::Colon)
+            {
+                Token = Tokenizer.GetToken();
+                return Fail("Expected ':'");
+            }
+            Tokenizer.GetToken();
+
+            Depth = Stack.size();
+            State = ReaderState::Value;
+            Event = JsonReaderEvent::Key;
+            return true;
+        }
+
+        bool CloseContainer()
+        {
+            Event = Stack.back() == JsonTokenType::ObjectStart ? JsonReaderEvent::ObjectEnd : JsonReaderEvent::ArrayEnd;
+            Stack.pop_back();
+            
+            Depth = Stack.size();
+            State = ReaderState::AfterValue;
+            return true;
+        }
+
+        bool Fail(std::string_view Message)
+        {
+            ErrorMessage = Tokenizer.FormatError(Token, Token.Type == JsonTokenType::Error ? Token.Value : Message);
+            Event = JsonReaderEvent::Error;
+            return false;
+        }
+
+        JsonTokenizer Tokenizer;
+        JsonStructuralIndex StructuralIndex;
+        JsonToken Token{};
+        std::vector<JsonTokenType> Stack{};
+        std::string Scratch{};
+        std::optional<std::string> ErrorMessage{};
+        
+        JsonReaderEvent Event{};
+        ReaderState State{};
+        size_t Depth{};
+        size_t MaxDepth{JsonParseOptions{}.MaxDepth};
+
+        friend class JsonBinder;
+    };
+
+    // Resumable event parser for input arriving in chunks. Strings, numbers and escape sequences may be split anywhere,
+    // only the token crossing a chunk boundary is buffered. Events are delivered to a CJsonEventHandler as in JsonEventParser.
+    class JsonStreamParser
+    {
+    public:
+        // Prepares the parser for a new document, only MaxDepth of the options applies
+        void Reset(const JsonParseOptions& Options = {})
+        {
+            MaxDepth = Options.MaxDepth;
+            Stack.clear();
+            Pending.clear();
+            ErrorMessage.reset();
+            
+            State = ParserState::Value;
+            PendingToken = PendingState::None;
+            StreamPosition = 0;
+            PendingStart = 0;
+            bEscapePending = false;
+            bComplete = false;
+            bStopped = false;
+        }
+
+        // Consumes the next chunk, the data does not need to outlive the call. Returns false on error or when the handler stopped.
+        template<CJsonEventHandler THandler>
+        bool Feed(std::span<const char> Chunk, THandler& Handler)
+        {
+            if(HasError() || bStopped) return false;
+
+            const char* const Begin = Chunk.data();
+            const char* const End = Begin + Chunk.size();
+            const char* Current = Begin;
+
+            if(PendingToken != PendingState::None)
+            {
+                Current = PendingToken == PendingState::String ? ScanString(Begin, End) : ScanScalar(Begin, End);
+                Pending.append(Begin, Current);
+                
+                if(Current == End)
+                {
+                    StreamPosition += Chunk.size();
+                    return true;
+                }
+
+                if(PendingToken == PendingState::String)
+                {
+                    Pending += '"';
+                    ++Current;
+                }
+                
+                PendingToken = PendingState::None;
+                if(!ProcessValueText(Pending, PendingStart, Handler)) return false;
+            }
+
+            while(Current < End)
+            {
+                const char Char = *Current;
+                const size_t TokenPosition = StreamPosition + static_cast<size_t>(Current - Begin);
+                
+                switch(Char)
+                {
+                    case ' ': case '\t': case '\n': case '\r':
+                    {
+                        ++Current;
+                        continue;
+                    }
+                    case '{': case '}': case '[': case ']': case ',': case ':':
+                    {
+                        ++Current;
+                        if(!ProcessToken({GetStructuralType(Char), TokenPosition, std::string_view{Current - 1, 1}}, Handler)) return false;
+                        continue;
+                    }
+                    case '"':
+                    {
+                        bEscapePending = false;
+                        const char* Quote = ScanString(Current + 1, End);
+                        if(Quote == End)
+                        {
+                            StartPending(PendingState::String, Current, End, TokenPosition);
+                            Current = End;
+                            continue;
+                        }
+
+                        const std::string_view Text{Current, static_cast<size_t>(Quote + 1 - Current)};
+                        Current = Quote + 1;
+                        if(!ProcessValueText(Text, TokenPosition, Handler)) return false;
+                        continue;
+                    }
+                    default:
+                    {
+                        const char* ScalarEnd = ScanScalar(Current, End);
+                        if(ScalarEnd == End)
+                        {
+                            StartPending(PendingState::Scalar, Current, End, TokenPosition);
+                            Current = End;
+                            continue;
+                        }
+
+                        const std::string_view Text{Current, static_cast<size_t>(ScalarEnd - Current)};
+                        Current = ScalarEnd;
+                        if(!ProcessValueText(Text, TokenPosition, Handler)) return false;
+                    }
+                }
+            }
+
+            StreamPosition += Chunk.size();
+            return true;
+        }
+
+        // Signals the end of the input, completing a trailing root number. Returns true if a whole document was parsed.
+        template<CJsonEventHandler THandler>
+        bool Finish(THandler& Handler)
+        {
+            if(HasError() || bStopped) return false;
+
+            if(PendingToken == PendingState::Scalar)
+            {
+                PendingToken = PendingState::None;
+                if(!ProcessValueText(Pending, PendingStart, Handler)) return false;
+            }
+
+            if(!bComplete)
+            {
+                return Fail({JsonTokenType::None, StreamPosition, ""}, "Unexpected end of input");
+            }
+            return true;
+        }
+
+        // True once the root value has been fully parsed
+        [[nodiscard]] bool IsComplete() const
+        {
+            return bComplete;
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+    private:
+        enum class ParserState : uint8_t
+        {
+            Value,
+            FirstElement,
+            FirstKey,
+            Key,
+            Colon,
+            AfterValue
+        };
+
+        enum class PendingState : uint8_t
+        {
+            None,
+            String,
+            Scalar
+        };
+
+        static JsonTokenType GetStructuralType(char Char)
+        {
+            switch(Char)
+            {
+                case '{': return JsonTokenType::ObjectStart;
+                case '}': return JsonTokenType::ObjectEnd;
+                case '[': return JsonTokenType::ArrayStart;
+                case ']': return JsonTokenType::ArrayEnd;
+                case ',': return JsonTokenType::Comma;
+                default: return JsonTokenType::Colon;
+            }
+        }
+
+        // Returns the closing quote or End, remembering a trailing backslash for the next chunk
+        const char* ScanString(const char* Current, const char* End)
+        {
+            if(bEscapePending && Current < End)
+            {
+                bEscapePending = false;
+                ++Current;
+            }
+            
+            while((Current = Detail::FindQuoteOrBackslash(Current, End)) < End && *Current == '\\')
+            {
+                if(End - Current < 2)
+                {
+                    bEscapePending = true;
+                    return End;
+                }
+                Current += 2;
+            }
+            return Current;
+        }
+
+        static const char* ScanScalar(const char* Current, const char* End)
+        {
+            for(; Current < End; ++Current)
+            {
+                switch(*Current)
+                {
+                    case ' ': case '\t': case '\n': case '\r':
+                    case '{': case '}': case '[': case ']': case ',': case ':': case '"':
+                        return Current;
+                    default:;
+                }
+            }
+            return End;
+        }
+
+        void StartPending(PendingState Kind, const char* Begin, const char* End, size_t Position)
+        {
+            PendingToken = Kind;
+            PendingStart = Position;
+            Pending.assign(Begin, End);
+        }
+
+        // Tokenizes one complete string or scalar
+        template<typename THandler>
+        bool ProcessValueText(std::string_view Text, size_t Position, THandler& Handler)
+        {
+            ValueTokenizer.Init(Text);
+            
+            size_t Offset{};
+            JsonToken Token = ValueTokenizer.ReadToken(Offset);
+            Token.Position = Position;
+            
+            if(Token.Type != JsonTokenType::Error && Offset != Text.size())
+            {
+                Token = {JsonTokenType::Error, Position, "Invalid token"};
+            }
+            return ProcessToken(Token, Handler);
+        }
+
+        template<typename THandler>
+        bool ProcessToken(const JsonToken& Token, THandler& Handler)
+        {
+            if(Token.Type == JsonTokenType::Error)
+            {
+                return Fail(Token, Token.Value);
+            }
+            
+            switch(State)
+            {
+                case ParserState::Value:
+                {
+                    return ProcessValue(Token, Handler);
+                }
+                case ParserState::FirstElement:
+                {
+                    return Token.Type == JsonTokenType::ArrayEnd ? CloseContainer(Handler) : ProcessValue(Token, Handler);
+                }
+                case ParserState::FirstKey:
+                {
+                    return Token.Type == JsonTokenType::ObjectEnd ? CloseContainer(Handler) : ProcessKey(Token, Handler);
+                }
+                case ParserState::Key:
+                {
+                    return ProcessKey(Token, Handler);
+                }
+                case ParserState::Colon:
+                {
+                    if(Token.Type != JsonTokenType::Colon)
+                    {
+                        return Fail(Token, "Expected ':'");
+                    }
+                    
+                    State = ParserState::Value;
+                    return true;
+                }
+                case ParserState::AfterValue:
+                {
+                    if(Stack.empty())
+                    {
+                        return Fail(Token, "Unexpected data after the root value");
+                    }
+
+                    const bool bObject = Stack.back() == JsonTokenType::ObjectStart;
+                    if(Token.Type == JsonTokenType::Comma)
+                    {
+                        State = bObject ? ParserState::Key : ParserState::Value;
+                        return true;
+                    }
+                    if(Token.Type != (bObject ? JsonTokenType::ObjectEnd : JsonTokenType::ArrayEnd))
+                    {
+                        return Fail(Token, bObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+                    }
+                    return CloseContainer(Handler);
+                }
+            }
+            return false;
+        }
+
+        template<typename THandler>
+        bool ProcessValue(const JsonToken& Token, THandler& Handler)
+        {
+            if((Token.Type == JsonTokenType::ObjectStart || Token.Type == JsonTokenType::ArrayStart) && Stack.size() >= MaxDepth)
+            {
+                return Fail(Token, "Maximum nesting depth exceeded");
+            }
+            
+            bool bContinue = true;
+            switch(Token.Type)
+            {
+                case JsonTokenType::ObjectStart:
+                {
+                    Stack.push_back(JsonTokenType::ObjectStart);
+                    State = ParserState::FirstKey;
+                    return Continue(Handler.OnObjectStart());
+                }
+                case JsonTokenType::ArrayStart:
+                {
+                    Stack.push_back(JsonTokenType::ArrayStart);
+                    State = ParserState::FirstElement;
+                    return Continue(Handler.OnArrayStart());
+                }
+                case JsonTokenType::String:
+                {
+                    bContinue = Handler.OnString(GetStringView(Token));
+                    break;
+                }
+                case JsonTokenType::Number:
+                {
+                    bContinue = Token.bIsFloat ? Handler.OnDouble(Token.Number.Float) : Handler.OnInt64(Token.Number.Integer);
+                    break;
+                }
+                case JsonTokenType::Boolean:
+                {
+                    bContinue = Handler.OnBool(Token.Value == "true");
+                    break;
+                }
+                case JsonTokenType::Null:
+                {
+                    bContinue = Handler.OnNull();
+                    break;
+                }
+                default:
+                {
+                    return Fail(Token, std::format("Unexpected token while parsing value: {}", Token.Value));
+                }
+            }
+
+            EndValue();
+            return Continue(bContinue);
+        }
+
+        template<typename THandler>
+        bool ProcessKey(const JsonToken& Token, THandler& Handler)
+        {
+            if(Token.Type != JsonTokenType::String)
+            {
+                return Fail(Token, "Expected string key");
+            }
+
+            State = ParserState::Colon;
+            return Continue(Handler.OnKey(GetStringView(Token)));
+        }
+
+        template<typename THandler>
+        bool CloseContainer(THandler& Handler)
+        {
+            const bool bObject = Stack.back() == JsonTokenType::ObjectStart;
+            Stack.pop_back();
+            
+            EndValue();
+            return Continue(bObject ? Handler.OnObjectEnd() : Handler.OnArrayEnd());
+        }
+
+        void EndValue()
+        {
+            State = ParserState::AfterValue;
+            bComplete = Stack.empty();
+        }
+
+        bool Continue(bool bHandlerContinues)
+        {
+            bStopped = !bHandlerContinues;
+            return bHandlerContinues;
+        }
+
+        std::string_view GetStringView(const JsonToken& Token)
+        {
+            if(!Token.bHasEscapes) return Token.Value;
+
+            Scratch = JsonTokenizer::DecodeString(Token);
+            return Scratch;
+        }
+
+        // The input is gone by the time of the error, only the position and token are reported
+        bool Fail(const JsonToken& Token, std::string_view Message)
+        {
+            const std::string_view TokenValue = Token.Type == JsonTokenType::Error ? "Tokenization Error" : Token.Value;
+            ErrorMessage = std::format("Error at position {}[{}] \nError Reason: {}", Token.Position, TokenValue, Message);
+            return false;
+        }
+
+        JsonTokenizer ValueTokenizer;
+        std::vector<JsonTokenType> Stack{};
+        std::string Pending{};
+        std::string Scratch{};
+        std::optional<std::string> ErrorMessage{};
+
+        size_t StreamPosition{};
+        size_t PendingStart{};
+        size_t MaxDepth{JsonParseOptions{}.MaxDepth};
+        ParserState State{};
+        PendingState PendingToken{};
+        bool bEscapePending{};
+        bool bComplete{};
+        bool bStopped{};
+    };
+
+    namespace Detail
+    {
+        // Moves to the next non-blank line of newline-delimited JSON, stripping a trailing CR
+        inline bool NextJsonLine(std::string_view Input, size_t& Offset, std::string_view& Line, size_t& LineNumber)
+        {
+            while(Offset < Input.size())
+            {
+                const size_t LineEnd = std::min(Input.find('\n', Offset), Input.size());
+                Line = Input.substr(Offset, LineEnd - Offset);
+                Offset = LineEnd + 1;
+                ++LineNumber;
+
+                if(!Line.empty() && Line.back() == '\r')
+                {
+                    Line.remove_suffix(1);
+                }
+                if(!std::all_of(Line.begin(), Line.end(), Detail::IsJsonWhitespace))
+                {
+                    return true;
+                }
+            }
+
+            Line = {};
+            return false;
+        }
+    }
+
+    // Iterates the documents of newline-delimited JSON (NDJSON / JSON Lines) held in one buffer.
+    // Every line is parsed into the same Json, whose arena is recycled between lines as long as no container of the
+    // previous line is still referenced. A malformed line only sets the error of that line, iteration carries on.
+    class JsonLinesReader
+    {
+    public:
+        // The input must outlive the reader. The arena is always used, regardless of Options.bUseArena.
+        void Init(std::string_view InputIn, const JsonParseOptions& OptionsIn = {})
+        {
+            Input = InputIn;
+            Options = OptionsIn;
+            Options.bUseArena = true;
+            
+            Offset = 0;
+            LineNumber = 0;
+            Line = {};
+        }
+
+        // Parses the next non-blank line, false once the input is exhausted
+        bool Next()
+        {
+            if(!Detail::NextJsonLine(Input, Offset, Line, LineNumber)) return false;
+            
+            Document.Parse(Line, Options);
+            return true;
+        }
+
+        // Document of the current line, overwritten by the next call to Next
+        [[nodiscard]] Json& GetDocument()
+        {
+            return Document;
+        }
+
+        // 1-based line number of the current document
+        [[nodiscard]] size_t GetLineNumber() const
+        {
+            return LineNumber;
+        }
+
+        [[nodiscard]] std::string_view GetLine() const
+        {
+            return Line;
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return Document.HasError();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return Document.GetError();
+        }
+
+    private:
+        Json Document;
+        JsonParseOptions Options{};
+        
+        std::string_view Input{};
+        std::string_view Line{};
+        size_t Offset{};
+        size_t LineNumber{};
+    };
+
+    struct JsonParallelOptions
+    {
+        JsonParseOptions ParseOptions{};
+
+        // Worker threads including the calling one, 0 uses every hardware thread
+        size_t ThreadCount{0};
+
+        // Approximate number of input bytes handed to a worker at a time, batches always end on a line boundary
+        size_t BatchSize{256 * 1024};
+
+        // Deliver the documents in input order, otherwise batches are delivered as soon as they are parsed
+        bool bOrdered{true};
+    };
+
+    // Parses newline-delimited JSON on several threads. The input is split into batches at line boundaries which idle
+    // workers claim one after the other, every worker allocating its documents from its own arena.
+    // The consumer is never called concurrently and receives (LineNumber, Line, Json&), errors being reported by the
+    // document. Documents are only valid during the call, copies and values taken from them keep their arena alive.
+    // An exception thrown by the consumer or a worker stops parsing and is rethrown.
+    class JsonParallelLinesParser
+    {
+    public:
+        template<typename TConsumer>
+        requires std::invocable<TConsumer&, size_t, std::string_view, Json&>
+        void Parse(std::string_view Input, TConsumer&& Consumer, const JsonParallelOptions& Options = {})
+        {
+            SplitBatches(Input, std::max<size_t>(Options.BatchSize, 1));
+
+            size_t ThreadCount = Options.ThreadCount ? Options.ThreadCount : std::thread::hardware_concurrency();
+            ThreadCount = std::clamp<size_t>(ThreadCount, 1, std::max<size_t>(Batches.size(), 1));
+            if(Workers.size() < ThreadCount)
+            {
+                Workers.resize(ThreadCount);
+            }
+
+            NextBatch = 0;
+            NextDelivery = 0;
+            bAborted = false;
+            Exception = nullptr;
+
+            std::vector<std::thread> Threads;
+            Threads.reserve(ThreadCount - 1);
+            try
+            {
+                for(size_t Index = 1; Index < ThreadCount; ++Index)
+                {
+                    Threads.emplace_back([this, &Consumer, &Options, Index]() { RunWorker(Workers[Index], Consumer, Options); });
+                }
+            }
+            catch(...)
+            {
+                Abort(std::current_exception());
+            }
+            
+            RunWorker(Workers[0], Consumer, Options);
+            for(auto& Thread : Threads)
+            {
+                Thread.join();
+            }
+
+            if(Exception)
+            {
+                std::rethrow_exception(Exception);
+            }
+        }
+
+    private:
+        struct Batch
+        {
+            std::string_view Input{};
+            size_t FirstLine{};
+        };
+
+        struct ParsedLine
+        {
+            size_t LineNumber{};
+            std::string_view Line{};
+        };
+        
+        // State kept by a worker across batches and Parse calls so its storage is reused
+        struct Worker
+        {
+            std::shared_ptr<JsonArena> Arena{std::make_shared<JsonArena>()};
+            std::deque<Json> Documents{};
+            std::vector<ParsedLine> Lines{};
+        };
+
+        void SplitBatches(std::string_view Input, size_t BatchSize)
+        {
+            Batches.clear();
+            
+            size_t Begin{};
+            size_t Line{};
+            while(Begin < Input.size())
+            {
+                size_t End = Input.size();
+                if(Input.size() - Begin > BatchSize)
+                {
+                    End = std::min(Input.find('\n', Begin + BatchSize - 1), Input.size() - 1) + 1;
+                }
+
+                Batches.push_back({Input.substr(Begin, End - Begin), Line});
+                Line += static_cast<size_t>(std::count(Input.begin() + Begin, Input.begin() + End, '\n'));
+                Begin = End;
+            }
+        }
+
+        template<typename TConsumer>
+        void RunWorker(Worker& State, TConsumer& Consumer, const JsonParallelOptions& Options)
+        {
+            JsonParseOptions ParseOptions = Options.ParseOptions;
+            ParseOptions.SharedArena = State.Arena;
+            
+            for(size_t BatchIndex = NextBatch++; BatchIndex < Batches.size() && !bAborted; BatchIndex = NextBatch++)
+            {
+                // The previous batch has been delivered, release its documents before recycling the arena. Values the consumer
+                // kept still reference the arena, then the batch gets a fresh one instead.
+                for(Json& Document : State.Documents)
+                {
+                    Document.Reset(false);
+                    Document.Arena.reset();
+                }
+                if(State.Arena.use_count() == 2)
+                {
+                    State.Arena->Reset();
+                }
+                else
+                {
+                    State.Arena = std::make_shared<JsonArena>();
+                    ParseOptions.SharedArena = State.Arena;
+                }
+                State.Lines.clear();
+
+                // An exception escaping the thread would terminate the process, it is rethrown by Parse instead
+                try
+                {
+                    const Batch& Current = Batches[BatchIndex];
+                    size_t Offset{};
+                    std::string_view Line{};
+                    size_t LineNumber = Current.FirstLine;
+                    while(Detail::NextJsonLine(Current.Input, Offset, Line, LineNumber))
+                    {
+                        if(State.Lines.size() == State.Documents.size())
+                        {
+                            State.Documents.emplace_back();
+                        }
+                        
+                        State.Documents[State.Lines.size()].Parse(Line, ParseOptions);
+                        State.Lines.push_back({LineNumber, Line});
+                    }
+                }
+                catch(...)
+                {
+                    Abort(std::current_exception());
+                    break;
+                }
+
+                std::unique_lock Lock(DeliveryMutex);
+                if(Options.bOrdered)
+                {
+                    DeliveryCondition.wait(Lock, [this, BatchIndex]() { return NextDelivery == BatchIndex || bAborted; });
+                    if(bAborted) break;
+                }
+                
+                try
+                {
+                    for(size_t Index = 0; Index < State.Lines.size(); ++Index)
+                    {
+                        Consumer(State.Lines[Index].LineNumber, State.Lines[Index].Line, State.Documents[Index]);
+                    }
+                }
+                catch(...)
+                {
+                    if(!Exception)
+                    {
+                        Exception = std::current_exception();
+                    }
+                    bAborted = true;
+                }
+                
+                ++NextDelivery;
+                DeliveryCondition.notify_all();
+            }
+        }
+
+        // Stops all workers, the first exception is rethrown by Parse
+        void Abort(std::exception_ptr NewException)
+        {
+            std::scoped_lock Lock(DeliveryMutex);
+            if(!Exception)
+            {
+                Exception = std::move(NewException);
+            }
+            bAborted = true;
+            DeliveryCondition.notify_all();
+        }
+
+        std::vector<Batch> Batches{};
+        std::vector<Worker> Workers{};
+        
+        std::atomic<size_t> NextBatch{};
+        std::atomic<bool> bAborted{};
+        std::mutex DeliveryMutex{};
+        std::condition_variable DeliveryCondition{};
+        size_t NextDelivery{};
+        std::exception_ptr Exception{};
+    };
+
+    // Parses a document whose root is one large array on several threads. A structural pre-scan finds the top-level
+    // element boundaries, then workers claim runs of elements and parse them straight into their JsonArray::Values slots.
+    // Every worker allocates from its own arena, kept alive by the containers it produced.
+    class JsonParallelArrayParser
+    {
+    public:
+        // Returns nullptr on error. An exception thrown by a worker is rethrown once all workers have stopped.
+        // Options.bOrdered is ignored, the elements always keep their order.
+        std::shared_ptr<JsonArray> Parse(std::string_view Input, const JsonParallelOptions& Options = {})
+        {
+            ErrorMessage.reset();
+            if(!StructuralIndex.Build(Input))
+            {
+                ErrorMessage = "Input too large for the structural index";
+                return {};
+            }
+            if(!FindElements(Input)) return {};
+
+            auto Result = std::make_shared<JsonArray>();
+            Result->Values.resize(Elements.size());
+            
+            // Runs of consecutive elements of roughly BatchSize bytes
+            Runs.clear();
+            for(size_t Element = 0; Element < Elements.size(); )
+            {
+                const size_t RunEnd = Elements[Element] + std::max<size_t>(Options.BatchSize, 1);
+                Runs.push_back(Element);
+                while(++Element < Elements.size() && Elements[Element] < RunEnd) {}
+            }
+            Runs.push_back(Elements.size());
+
+            const size_t RunCount = Runs.size() - 1;
+            size_t ThreadCount = Options.ThreadCount ? Options.ThreadCount : std::thread::hardware_concurrency();
+            ThreadCount = std::clamp<size_t>(ThreadCount, 1, std::max<size_t>(RunCount, 1));
+
+            NextRun = 0;
+            FirstFailedRun = RunCount;
+            Exception = nullptr;
+            
+            std::vector<std::thread> Threads;
+            Threads.reserve(ThreadCount - 1);
+            try
+            {
+                for(size_t Index = 1; Index < ThreadCount; ++Index)
+                {
+                    Threads.emplace_back([this, Input, &Result, &Options]() { RunWorker(Input, Result->Values, Options); });
+                }
+            }
+            catch(...)
+            {
+                Abort(std::current_exception());
+            }
+            
+            RunWorker(Input, Result->Values, Options);
+            for(auto& Thread : Threads)
+            {
+                Thread.join();
+            }
+
+            if(Exception)
+            {
+                std::rethrow_exception(Exception);
+            }
+            if(HasError()) return {};
+            return Result;
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return ErrorMessage.has_value();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return ErrorMessage ? std::string_view{*ErrorMessage} : std::string_view{};
+        }
+
+    private:
+        // Collects the start offset of every top-level element from the structural index
+        bool FindElements(std::string_view Input)
+        {
+            Elements.clear();
+            
+            const auto Positions = StructuralIndex.GetPositions();
+            if(Positions.empty() || Input[Positions[0]] != '[')
+            {
+                return Fail(Input, Positions.empty() ? Input.size() : Positions[0], "Expected '['");
+            }
+
+            size_t Depth{};
+            bool bExpectElement{};
+            for(size_t Index = 0; Index < Positions.size(); ++Index)
+            {
+                const size_t Position = Positions[Index];
+                const char Char = Input[Position];
+                
+                if(Depth == 1 && bExpectElement)
+                {
+                    bExpectElement = false;
+                    if(Char != ']')
+                    {
+                        Elements.push_back(Position);
+                    }
+                    else if(!Elements.empty())
+                    {
+                        return Fail(Input, Position, "Unexpected token while parsing value: ]");
+                    }
+                }
+
+                switch(Char)
+                {
+                    case '[': case '{':
+                    {
+                        bExpectElement = ++Depth == 1;
+                        break;
+                    }
+                    case ']': case '}':
+                    {
+                        if(--Depth == 0)
+                        {
+                            if(Index + 1 < Positions.size())
+                            {
+                                return Fail(Input, Positions[Index + 1], "Unexpected data after the root value");
+                            }
+                            return true;
+                        }
+                        break;
+                    }
+                    case ',':
+                    {
+                        bExpectElement = Depth == 1;
+                        break;
+                    }
+                    default:;
+                }
+            }
+
+            return Fail(Input, Input.size(), "Expected ',' or ']'");
+        }
+
+        void RunWorker(std::string_view Input, std::pmr::vector<JsonValue>& Values, const JsonParallelOptions& Options)
+        {
+            // An exception escaping the thread would terminate the process, it is rethrown by Parse instead
+            try
+            {
+                Json Worker;
+                JsonParseOptions ParseOptions = Options.ParseOptions;
+                ParseOptions.SharedArena = std::make_shared<JsonArena>();
+
+                for(size_t Run = NextRun++; Run + 1 < Runs.size(); Run = NextRun++)
+                {
+                    const std::span<JsonValue> Slots{Values.data() + Runs[Run], Runs[Run + 1] - Runs[Run]};
+                    if(Worker.ParseArrayElements(Input, StructuralIndex, Elements[Runs[Run]], Slots, ParseOptions)) continue;
+
+                    // Report the error of the earliest run so the message does not depend on scheduling
+                    std::scoped_lock Lock(ErrorMutex);
+                    if(Run < FirstFailedRun)
+                    {
+                        FirstFailedRun = Run;
+                        ErrorMessage = Worker.GetError();
+                    }
+                    NextRun = Runs.size();
+                }
+            }
+            catch(...)
+            {
+                Abort(std::current_exception());
+            }
+        }
+
+        // Stops all workers, the first exception is rethrown by Parse
+        void Abort(std::exception_ptr NewException)
+        {
+            std::scoped_lock Lock(ErrorMutex);
+            if(!Exception)
+            {
+                Exception = std::move(NewException);
+            }
+            NextRun = Runs.size();
+        }
+
+        bool Fail(std::string_view Input, size_t Position, std::string_view Message)
+        {
+            JsonTokenizer Tokenizer;
+            Tokenizer.Init(Input);
+            ErrorMessage = Tokenizer.FormatError({JsonTokenType::None, Position, Position < Input.size() ? Input.substr(Position, 1) : ""}, Message);
+            return false;
+        }
+
+        JsonStructuralIndex StructuralIndex;
+        std::vector<size_t> Elements{};
+        std::vector<size_t> Runs{};
+        
+        std::atomic<size_t> NextRun{};
+        std::mutex ErrorMutex{};
+        size_t FirstFailedRun{};
+        std::exception_ptr Exception{};
+        std::optional<std::string> ErrorMessage{};
+    };
+
+    // Emits JSON straight into a string or a sink without building a document, using the same escaping, number formatting
+    // and layout as Json::Serialize. The caller is responsible for a well-formed call sequence, keys only inside objects,
+    // which debug builds assert.
+    template<typename TOutput>
+    class JsonWriter
+    {
+    public:
+        // Appends to Target if it is a std::string, otherwise Target is a CJsonSink fed through a bounded buffer
+        template<typename TTarget>
+        explicit JsonWriter(TTarget& Target, const JsonSerializeOptions& OptionsIn = {}) :
+        Output(MakeOutput(Target, OptionsIn)),
+        Options(OptionsIn)
+        {
+            
+        }
+
+        JsonWriter(const JsonWriter& Other) = delete;
+        JsonWriter& operator=(const JsonWriter& Other) = delete;
+
+        void BeginObject()
+        {
+            BeginContainer(true);
+        }
+
+        void EndObject()
+        {
+            EndContainer('}');
+        }
+
+        void BeginArray()
+        {
+            BeginContainer(false);
+        }
+
+        void EndArray()
+        {
+            EndContainer(']');
+        }
+
+        void Key(std::string_view Name)
+        {
+            assert(!Levels.empty() && Levels.back().bObject && "Key is only valid inside an object");
+            assert(!bAfterKey && "Key needs a value before the next key");
+            
+            std::string& Result = Output.GetBuffer();
+            if(Levels.back().Count++ > 0)
+            {
+                Result += ',';
+            }
+            
+            if(Options.bPretty)
+            {
+                Result += '\n';
+                Result.append(Levels.size(), '\t');
+            }
+
+            Detail::AppendEscapedString(Result, Name);
+            Result += ':';
+            bAfterKey = true;
+        }
+
+        void Value(std::string_view String)
+        {
+            BeginValue(false);
+            Detail::AppendEscapedString(Output.GetBuffer(), String);
+            EndValue();
+        }
+
+        void Value(const char* String)
+        {
+            Value(std::string_view{String});
+        }
+
+        void Value(bool bValue)
+        {
+            BeginValue(false);
+            Output.GetBuffer() += bValue ? "true" : "false";
+            EndValue();
+        }
+
+        template<std::integral T>
+        requires(!std::is_same_v<T, bool>)
+        void Value(T Integer)
+        {
+            BeginValue(false);
+            Detail::AppendInteger(Output.GetBuffer(), Integer);
+            EndValue();
+        }
+
+        void Value(double Float)
+        {
+            BeginValue(false);
+            Detail::AppendDouble(Output.GetBuffer(), Float, Options.FloatPrecision);
+            EndValue();
+        }
+
+        void Value(std::nullptr_t)
+        {
+            BeginValue(false);
+            Output.GetBuffer() += "null";
+            EndValue();
+        }
+
+        // Hands everything written so far to the sink, false if the sink failed
+        bool Flush()
+        {
+            if constexpr(requires { Output.Flush(); })
+            {
+                return Output.Flush();
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return Output.HasError();
+        }
+
+        // Nesting depth of the container being written
+        [[nodiscard]] size_t GetDepth() const
+        {
+            return Levels.size();
+        }
+
+    private:
+        struct Level
+        {
+            size_t Count{};
+            bool bObject{};
+        };
+
+        template<typename TTarget>
+        static TOutput MakeOutput(TTarget& Target, const JsonSerializeOptions& Options)
+        {
+            if constexpr(std::is_same_v<TOutput, Detail::StringOutput>)
+            {
+                return TOutput{Target};
+            }
+            else
+            {
+                return TOutput{Target, Options.StreamBufferSize};
+            }
+        }
+        
+        // Writes the separator and indentation in front of a value, matching Json::Serialize
+        void BeginValue(bool bContainer)
+        {
+            std::string& Result = Output.GetBuffer();
+            if(bAfterKey)
+            {
+                bAfterKey = false;
+                if(Options.bPretty && bContainer)
+                {
+                    Result += '\n';
+                    Result.append(Levels.size(), '\t');
+                }
+                else
+                {
+                    Result += ' ';
+                }
+                return;
+            }
+
+            if(Levels.empty()) return;
+            
+            assert(!Levels.back().bObject && "Values inside an object need a key");
+            if(Levels.back().Count++ > 0)
+            {
+                Result += ',';
+            }
+            if(Options.bPretty)
+            {
+                Result += '\n';
+                Result.append(Levels.size(), '\t');
+            }
+        }
+
+        void EndValue()
+        {
+            Output.Commit();
+        }
+
+        void BeginContainer(bool bObject)
+        {
+            BeginValue(true);
+            Output.GetBuffer() += bObject ? '{' : '[';
+            Levels.push_back({0, bObject});
+        }
+
+        void EndContainer(char Close)
+        {
+            assert(!Levels.empty() && "End without a matching Begin");
+            assert(Levels.back().bObject == (Close == '}') && !bAfterKey && "Container closed with the wrong End or after a key");
+            
+            const bool bHasValues = Levels.back().Count > 0;
+            Levels.pop_back();
+
+            std::string& Result = Output.GetBuffer();
+            if(Options.bPretty && bHasValues)
+            {
+                Result += '\n';
+                Result.append(Levels.size(), '\t');
+            }
+            
+            Result += Close;
+            EndValue();
+        }
+
+        TOutput Output;
+        JsonSerializeOptions Options{};
+        std::vector<Level> Levels{};
+        bool bAfterKey{};
+    };
+
+    JsonWriter(std::string&) -> JsonWriter<Detail::StringOutput>;
+    JsonWriter(std::string&, const JsonSerializeOptions&) -> JsonWriter<Detail::StringOutput>;
+
+    template<CJsonSink TSink>
+    JsonWriter(TSink&) -> JsonWriter<JsonBufferedOutput<TSink>>;
+    
+    template<CJsonSink TSink>
+    JsonWriter(TSink&, const JsonSerializeOptions&) -> JsonWriter<JsonBufferedOutput<TSink>>;
+
+    // Maps a JSON key to a data member of TClass
+    template<typename TClass, typename TMember>
+    struct JsonField
+    {
+        std::string_view Name;
+        TMember TClass::* Member;
+    };
+
+    // Specialize with a static constexpr std::tuple of JsonField named Fields to bind a struct:
+    // template<> struct BMJson::TJsonBinding<User> { static constexpr std::tuple Fields{BMJson::JsonField{"name", &User::Name}, ...}; };
+    template<typename T>
+    struct TJsonBinding;
+
+    template<typename T>
+    concept CJsonBound = requires { TJsonBinding<T>::Fields; };
+
+    namespace Detail
+    {
+        template<typename T>
+        struct TIsOptional : std::false_type {};
+
+        template<typename T>
+        struct TIsOptional<std::optional<T>> : std::true_type {};
+
+        template<typename T>
+        struct TIsVector : std::false_type {};
+
+        template<typename T, typename TAllocator>
+        struct TIsVector<std::vector<T, TAllocator>> : std::true_type {};
+
+        template<typename T>
+        struct TIsStringMap : std::false_type {};
+
+        template<typename T, typename TCompare, typename TAllocator>
+        struct TIsStringMap<std::map<std::string, T, TCompare, TAllocator>> : std::true_type {};
+
+        template<typename T, typename THash, typename TEqual, typename TAllocator>
+        struct TIsStringMap<std::unordered_map<std::string, T, THash, TEqual, TAllocator>> : std::true_type {};
+
+        // Perfect hash over a fixed set of keys built at compile time. The key length and the bytes at the few positions which
+        // tell the keys apart are hashed, the hash picks a bucket and each bucket stores the displacement which moves its keys
+        // into free slots. Lookups cost a handful of byte loads, two multiplications and one comparison against the candidate key.
+        // Construction is bounded to stay well inside the compiler's constant evaluation limits: positions are only searched for
+        // up to MaxSelectedKeys keys, wider sets hash whole keys, and past MaxHashedKeys or when no displacement fits the table
+        // falls back to a linear scan.
+        template<size_t N>
+        class JsonKeyTable
+        {
+        public:
+            static constexpr size_t NotFound = N;
+            
+            consteval explicit JsonKeyTable(const std::array<std::string_view, N>& KeysIn) :
+            Keys(KeysIn)
+            {
+                if(N == 0) return;
+                
+                bHashAll = true;
+                bDuplicateKeys = FindDuplicates();
+                if(bDuplicateKeys) return;
+
+                if(N <= MaxSelectedKeys)
+                {
+                    bHashAll = false;
+                    if(SelectPositions() && Build()) return;
+                    bHashAll = true;
+                }
+                
+                if(N <= MaxHashedKeys && Build()) return;
+
+                bLinear = true;
+            }
+
+            // Index of Key in the table, NotFound for unknown keys
+            [[nodiscard]] constexpr size_t Find(std::string_view Key) const
+            {
+                if constexpr(N == 0)
+                {
+                    return NotFound;
+                }
+                else
+                {
+                    if(bLinear)
+                    {
+                        return static_cast<size_t>(std::find(Keys.begin(), Keys.end(), Key) - Keys.begin());
+                    }
+
+                    const uint64_t Hash = GetHash(Key);
+                    const size_t Index = Slots[GetSlot(Hash, Displacements[Hash & (BucketCount - 1)])];
+                    return Index < N && Keys[Index] == Key ? Index : NotFound;
+                }
+            }
+
+            [[nodiscard]] constexpr bool HasDuplicateKeys() const
+            {
+                return bDuplicateKeys;
+            }
+
+        private:
+            static constexpr size_t MaxPositions = 8;
+            static constexpr size_t MaxCandidatePositions = 32;
+            static constexpr size_t MaxSelectedKeys = 256;
+            static constexpr size_t MaxHashedKeys = 1024;
+            static constexpr size_t MaxDisplacement = 64 + 8 * N;
+            static constexpr size_t BucketCount = std::bit_ceil(N > 0 ? N : 1);
+            static constexpr size_t SlotCount = BucketCount * 2;
+            static constexpr size_t SlotBits = std::bit_width(SlotCount - 1);
+            static constexpr uint64_t Prime = 0x100000001B3ull;
+            
+            [[nodiscard]] constexpr uint64_t GetHash(std::string_view Key) const
+            {
+                uint64_t Hash = Key.size();
+                if(bHashAll)
+                {
+                    for(const char Char : Key)
+                    {
+                        Hash = (Hash ^ static_cast<uint8_t>(Char)) * Prime;
+                    }
+                }
+                else
+                {
+                    for(size_t Index = 0; Index < PositionCount; ++Index)
+                    {
+                        const size_t Position = Positions[Index];
+                        Hash = (Hash ^ (Position < Key.size() ? static_cast<uint8_t>(Key[Position]) : 0u)) * Prime;
+                    }
+                }
+                
+                Hash ^= Hash >> 33;
+                Hash *= 0xFF51AFD7ED558CCDull;
+                return Hash ^ (Hash >> 33);
+            }
+
+            [[nodiscard]] static constexpr size_t GetSlot(uint64_t Hash, uint32_t Displacement)
+            {
+                return static_cast<size_t>(((Hash ^ (Displacement * 0x9E3779B97F4A7C15ull)) * 0xC2B2AE3D27D4EB4Full) >> (64 - SlotBits));
+            }
+
+            // Sorts the whole-key hashes once, only keys with equal hashes are compared
+            [[nodiscard]] constexpr bool FindDuplicates() const
+            {
+                std::array<std::pair<uint64_t, size_t>, N> Hashes{};
+                for(size_t Index = 0; Index < N; ++Index)
+                {
+                    Hashes[Index] = {GetHash(Keys[Index]), Index};
+                }
+                std::sort(Hashes.begin(), Hashes.end());
+
+                for(size_t Index = 1; Index < N; ++Index)
+                {
+                    for(size_t Other = Index; Other > 0 && Hashes[Other - 1].first == Hashes[Index].first; --Other)
+                    {
+                        if(Keys[Hashes[Other - 1].second] == Keys[Hashes[Index].second]) return true;
+                    }
+                }
+                return false;
+            }
+
+            // Greedily adds the byte position which splits the most keys apart. Keys are kept grouped by their length and the bytes
+            // selected so far, so each candidate position only scans the keys which still collide.
+            constexpr bool SelectPositions()
+            {
+                std::array<size_t, N> Order{};
+                for(size_t Index = 0; Index < N; ++Index)
+                {
+                    Order[Index] = Index;
+                }
+                std::sort(Order.begin(), Order.end(), [&](size_t Left, size_t Right) { return Keys[Left].size() < Keys[Right].size(); });
+
+                // Candidate bytes of every key, zero past its end
+                std::array<uint8_t, N * MaxCandidatePositions> Bytes{};
+                for(size_t Index = 0; Index < N; ++Index)
+                {
+                    for(size_t Position = 0; Position < std::min(Keys[Index].size(), MaxCandidatePositions); ++Position)
+                    {
+                        Bytes[Index * MaxCandidatePositions + Position] = static_cast<uint8_t>(Keys[Index][Position]);
+                    }
+                }
+                auto GetByte = [&](size_t Index, size_t Position) { return Bytes[Index * MaxCandidatePositions + Position]; };
+
+                // Colliding groups as [Begin, End) ranges of Order
+                std::array<std::pair<size_t, size_t>, N> Groups{};
+                size_t GroupCount = 0;
+                auto CollectGroups = [&](auto&& IsSame)
+                {
+                    std::array<std::pair<size_t, size_t>, N> Split{};
+                    size_t SplitCount = 0;
+                    for(size_t Group = 0; Group < GroupCount; ++Group)
+                    {
+                        for(size_t Begin = Groups[Group].first, End = Begin; Begin < Groups[Group].second; Begin = End)
+                        {
+                            while(End < Groups[Group].second && IsSame(Order[Begin], Order[End])) ++End;
+                            if(End - Begin > 1) Split[SplitCount++] = {Begin, End};
+                        }
+                    }
+                    Groups = Split;
+                    GroupCount = SplitCount;
+                };
+                
+                Groups[GroupCount++] = {0, N};
+                CollectGroups([&](size_t Left, size_t Right) { return Keys[Left].size() == Keys[Right].size(); });
+
+                size_t MaxLength = 0;
+                for(size_t Group = 0; Group < GroupCount; ++Group)
+                {
+                    MaxLength = std::max(MaxLength, Keys[Order[Groups[Group].first]].size());
+                }
+                MaxLength = std::min(MaxLength, MaxCandidatePositions);
+
+                while(GroupCount > 0)
+                {
+                    if(PositionCount == MaxPositions) return false;
+
+                    size_t BestPosition = 0;
+                    size_t BestSplits = 0;
+                    for(size_t Position = 0; Position < MaxLength; ++Position)
+                    {
+                        // Raw pointers keep the per key step cheap in constant evaluation
+                        const uint8_t* Column = Bytes.data() + Position;
+                        size_t Splits = 0;
+                        for(size_t Group = 0; Group < GroupCount; ++Group)
+                        {
+                            std::array<uint64_t, 4> Seen{};
+                            const size_t* const End = Order.data() + Groups[Group].second;
+                            for(const size_t* Member = Order.data() + Groups[Group].first; Member != End; ++Member)
+                            {
+                                const uint8_t Byte = Column[*Member * MaxCandidatePositions];
+                                const uint64_t Bit = 1ull << (Byte & 63);
+                                uint64_t& Word = Seen[Byte >> 6];
+                                Splits += (Word & Bit) == 0;
+                                Word |= Bit;
+                            }
+                            --Splits;
+                        }
+                        
+                        if(Splits > BestSplits)
+                        {
+                            BestSplits = Splits;
+                            BestPosition = Position;
+                        }
+                    }
+                    if(BestSplits == 0) return false;
+
+                    Positions[PositionCount++] = BestPosition;
+                    for(size_t Group = 0; Group < GroupCount; ++Group)
+                    {
+                        std::sort(Order.begin() + Groups[Group].first, Order.begin() + Groups[Group].second, [&](size_t Left, size_t Right)
+                        {
+                            return GetByte(Left, BestPosition) < GetByte(Right, BestPosition);
+                        });
+                    }
+                    CollectGroups([&](size_t Left, size_t Right) { return GetByte(Left, BestPosition) == GetByte(Right, BestPosition); });
+                }
+                return true;
+            }
+
+            // Places the largest buckets first, trying a bounded number of displacements per bucket
+            constexpr bool Build()
+            {
+                std::array<uint64_t, N> Hashes{};
+                std::array<size_t, BucketCount + 1> BucketStarts{};
+                for(size_t Index = 0; Index < N; ++Index)
+                {
+                    Hashes[Index] = GetHash(Keys[Index]);
+                    ++BucketStarts[(Hashes[Index] & (BucketCount - 1)) + 1];
+                }
+                for(size_t Bucket = 0; Bucket < BucketCount; ++Bucket)
+                {
+                    BucketStarts[Bucket + 1] += BucketStarts[Bucket];
+                }
+
+                // Keys grouped by bucket
+                std::array<size_t, N> Members{};
+                std::array<size_t, BucketCount + 1> Fill = BucketStarts;
+                for(size_t Index = 0; Index < N; ++Index)
+                {
+                    Members[Fill[Hashes[Index] & (BucketCount - 1)]++] = Index;
+                }
+
+                std::array<size_t, BucketCount> Order{};
+                for(size_t Bucket = 0; Bucket < BucketCount; ++Bucket)
+                {
+                    Order[Bucket] = Bucket;
+                }
+                auto GetBucketSize = [&](size_t Bucket) { return BucketStarts[Bucket + 1] - BucketStarts[Bucket]; };
+                std::sort(Order.begin(), Order.end(), [&](size_t Left, size_t Right) { return GetBucketSize(Left) > GetBucketSize(Right); });
+
+                Slots.fill(NotFound);
+                Displacements.fill(0);
+                for(const size_t Bucket : Order)
+                {
+                    if(GetBucketSize(Bucket) == 0) break;
+
+                    bool bPlaced = false;
+                    for(uint32_t Displacement = 0; Displacement < MaxDisplacement && !bPlaced; ++Displacement)
+                    {
+                        size_t Placed = BucketStarts[Bucket];
+                        for(; Placed < BucketStarts[Bucket + 1]; ++Placed)
+                        {
+                            size_t& Slot = Slots[GetSlot(Hashes[Members[Placed]], Displacement)];
+                            if(Slot != NotFound) break;
+                            Slot = Members[Placed];
+                        }
+
+                        bPlaced = Placed == BucketStarts[Bucket + 1];
+                        if(bPlaced)
+                        {
+                            Displacements[Bucket] = Displacement;
+                            continue;
+                        }
+                        
+                        for(size_t Undo = BucketStarts[Bucket]; Undo < Placed; ++Undo)
+                        {
+                            Slots[GetSlot(Hashes[Members[Undo]], Displacement)] = NotFound;
+                        }
+                    }
+                    if(!bPlaced) return false;
+                }
+                return true;
+            }
+            
+            std::array<std::string_view, N> Keys{};
+            std::array<size_t, SlotCount> Slots{};
+            std::array<uint32_t, BucketCount> Displacements{};
+            std::array<size_t, MaxPositions> Positions{};
+            size_t PositionCount{};
+            bool bHashAll{};
+            bool bLinear{};
+            bool bDuplicateKeys{};
+        };
+
+        template<CJsonBound T, size_t... Indices>
+        consteval auto MakeKeyTable(std::index_sequence<Indices...>)
+        {
+            return JsonKeyTable<sizeof...(Indices)>{std::array<std::string_view, sizeof...(Indices)>{std::get<Indices>(TJsonBinding<T>::Fields).Name...}};
+        }
+    }
+
+    // Parses JSON straight into bound structs, std::vector, std::optional, std::map/std::unordered_map with string keys,
+    // strings, numbers and bools without building a JsonValue tree, and serializes them back through JsonWriter.
+    // Unknown keys are skipped, missing keys leave the member untouched.
+    class JsonBinder
+    {
+    public:
+        // Out is left partially filled on error
+        template<typename T>
+        bool Parse(std::string_view Input, T& Out, const JsonParseOptions& Options = {})
+        {
+            Reader.Init(Input, Options);
+            if(!Reader.Next() || !ReadValue(Out)) return false;
+
+            // Fails on trailing data
+            Reader.Next();
+            return !Reader.HasError();
+        }
+
+        // Writes Value to a std::string or a CJsonSink, false if the sink failed
+        template<typename T, typename TTarget>
+        requires(std::is_same_v<TTarget, std::string> || CJsonSink<TTarget>)
+        static bool Serialize(const T& Value, TTarget& Target, const JsonSerializeOptions& Options = {})
+        {
+            JsonWriter Writer{Target, Options};
+            WriteValue(Writer, Value);
+            return Writer.Flush();
+        }
+
+        template<typename T>
+        static std::string Serialize(const T& Value, const JsonSerializeOptions& Options = {})
+        {
+            std::string Result;
+            Serialize(Value, Result, Options);
+            return Result;
+        }
+
+        [[nodiscard]] bool HasError() const
+        {
+            return Reader.HasError();
+        }
+
+        [[nodiscard]] std::string_view GetError() const
+        {
+            return Reader.GetError();
+        }
+
+    private:
+        // Reads the value starting at the current event of the reader
+        template<typename T>
+        bool ReadValue(T& Out)
+        {
+            const JsonReaderEvent Event = Reader.GetType();
+            if constexpr(Detail::TIsOptional<T>::value)
+            {
+                if(Event == JsonReaderEvent::Null)
+                {
+                    Out.reset();
+                    return true;
+                }
+                return ReadValue(Out.emplace());
+            }
+            else if constexpr(std::is_same_v<T, bool>)
+            {
+                if(Event != JsonReaderEvent::Boolean) return Reader.Fail("Expected boolean");
+                Out = Reader.GetBool();
+                return true;
+            }
+            else if constexpr(std::is_integral_v<T>)
+            {
+                if(Event == JsonReaderEvent::Double)
+                {
+                    // Integer literals outside of the int64_t range arrive as doubles, unsigned types may still hold them
+                    const std::string_view Text = Reader.Token.Value;
+                    if(Text.find_first_of(".eE") != std::string_view::npos) return Reader.Fail("Expected integer");
+                    if(std::from_chars(Text.data(), Text.data() + Text.size(), Out).ec != std::errc{}) return Reader.Fail("Integer out of range");
+                    return true;
+                }
+                if(Event != JsonReaderEvent::Integer) return Reader.Fail("Expected integer");
+
+                const int64_t Integer = Reader.GetInt64();
+                if(!std::in_range<T>(Integer)) return Reader.Fail("Integer out of range");
+                Out = static_cast<T>(Integer);
+                return true;
+            }
+            else if constexpr(std::is_floating_point_v<T>)
+            {
+                if(Event != JsonReaderEvent::Double && Event != JsonReaderEvent::Integer) return Reader.Fail("Expected number");
+                Out = static_cast<T>(Reader.GetDouble());
+                return true;
+            }
+            else if constexpr(std::is_same_v<T, std::string>)
+            {
+                if(Event != JsonReaderEvent::String) return Reader.Fail("Expected string");
+                Out.assign(Reader.GetString());
+                return true;
+            }
+            else if constexpr(Detail::TIsVector<T>::value)
+            {
+                if(Event != JsonReaderEvent::ArrayStart) return Reader.Fail("Expected array");
+                
+                Out.clear();
+                while(Reader.Next())
+                {
+                    if(Reader.GetType() == JsonReaderEvent::ArrayEnd) return true;
+                    if(!ReadValue(Out.emplace_back())) return false;
+                }
+                return false;
+            }
+            else if constexpr(Detail::TIsStringMap<T>::value)
+            {
+                if(Event != JsonReaderEvent::ObjectStart) return Reader.Fail("Expected object");
+                
+                Out.clear();
+                while(Reader.Next())
+                {
+                    if(Reader.GetType() == JsonReaderEvent::ObjectEnd) return true;
+
+                    auto& Value = Out[std::string{Reader.GetString()}];
+                    if(!Reader.Next() || !ReadValue(Value)) return false;
+                }
+                return false;
+            }
+            else if constexpr(CJsonBound<T>)
+            {
+                if(Event != JsonReaderEvent::ObjectStart) return Reader.Fail("Expected object");
+                
+                while(Reader.Next())
+                {
+                    if(Reader.GetType() == JsonReaderEvent::ObjectEnd) return true;
+                    if(!ReadField(Out)) return false;
+                }
+                return false;
+            }
+            else
+            {
+                static_assert(sizeof(T) == 0, "Unsupported type, specialize TJsonBinding to bind a struct");
+            }
+        }
+
+        template<CJsonBound T, size_t Index>
+        static bool ReadMember(JsonBinder& Binder, T& Out)
+        {
+            return Binder.Reader.Next() && Binder.ReadValue(Out.*std::get<Index>(TJsonBinding<T>::Fields).Member);
+        }
+
+        template<CJsonBound T, size_t... Indices>
+        static consteval auto MakeMemberReaders(std::index_sequence<Indices...>)
+        {
+            return std::array<bool (*)(JsonBinder&, T&), sizeof...(Indices)>{&ReadMember<T, Indices>...};
+        }
+        
+        // Reads the value of the current key into the matching member, or skips it.
+        // Keys are dispatched through a perfect hash built at compile time from the binding.
+        template<CJsonBound T>
+        bool ReadField(T& Out)
+        {
+            using TFieldIndices = std::make_index_sequence<std::tuple_size_v<std::remove_const_t<decltype(TJsonBinding<T>::Fields)>>>;
+            
+            static constexpr auto KeyTable = Detail::MakeKeyTable<T>(TFieldIndices{});
+            static_assert(!KeyTable.HasDuplicateKeys(), "Duplicate key in TJsonBinding");
+            
+            static constexpr auto MemberReaders = MakeMemberReaders<T>(TFieldIndices{});
+
+            const size_t Index = KeyTable.Find(Reader.GetString());
+            return Index == KeyTable.NotFound ? Reader.SkipValue() : MemberReaders[Index](*this, Out);
+        }
+
+        template<typename TWriter, typename T>
+        static void WriteValue(TWriter& Writer, const T& Value)
+        {
+            if constexpr(Detail::TIsOptional<T>::value)
+            {
+                if(Value) WriteValue(Writer, *Value);
+                else Writer.Value(nullptr);
+            }
+            else if constexpr(std::is_same_v<T, bool> || std::is_integral_v<T> || std::is_convertible_v<const T&, std::string_view>)
+            {
+                Writer.Value(Value);
+            }
+            else if constexpr(std::is_floating_point_v<T>)
+            {
+                Writer.Value(static_cast<double>(Value));
+            }
+            else if constexpr(Detail::TIsVector<T>::value)
+            {
+                Writer.BeginArray();
+                for(const auto& Element : Value)
+                {
+                    WriteValue(Writer, Element);
+                }
+                Writer.EndArray();
+            }
+            else if constexpr(Detail::TIsStringMap<T>::value)
+            {
+                Writer.BeginObject();
+                for(const auto& [Key, Element] : Value)
+                {
+                    Writer.Key(Key);
+                    WriteValue(Writer, Element);
+                }
+                Writer.EndObject();
+            }
+            else if constexpr(CJsonBound<T>)
+            {
+                Writer.BeginObject();
+                std::apply([&](const auto&... Fields)
+                {
+                    ((Writer.Key(Fields.Name), WriteValue(Writer, Value.*Fields.Member)), ...);
+                }, TJsonBinding<T>::Fields);
+                Writer.EndObject();
+            }
+            else
+            {
+                static_assert(sizeof(T) == 0, "Unsupported type, specialize TJsonBinding to bind a struct");
+            }
+        }
+
+        JsonReader Reader;
+    };
 }
 
 #undef ThrowParserError
\ No newline at end of file